@@ -0,0 +1,224 @@
+/*
+ * HMS_JSON Library - Benchmarks
+ *
+ * Parses and serializes every file of the generated corpus and reports, per operation:
+ *
+ *      Time        best wall time of one run
+ *      MB/s        document bytes over that time
+ *      Allocs      heap allocations per document
+ *      Peak KiB    largest amount of heap in use during one run, over what was in use before it
+ *
+ * Flags follow Google Benchmark: --benchmark_filter=<substring>, --benchmark_min_time=<seconds>,
+ * plus --corpus_dir=<directory>. Build and run both flavours through the hms_json_run_benchmarks
+ * target; hms_json_bench uses the throwing API, hms_json_bench_noexcept the ParseError one.
+ */
+
+#include "HMS_JSON.h"
+#include "Corpus.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+
+#ifndef HMS_JSON_BENCH_CORPUS_DIR
+#define HMS_JSON_BENCH_CORPUS_DIR "corpus"
+#endif
+
+namespace {
+    /*
+     * Every heap block carries its size in a header so frees can be subtracted from the live byte
+     * count. The benchmark itself is single threaded apart from the library's own pool, which
+     * the serial parse and serialize paths measured here do not use.
+     */
+    constexpr size_t HEADER = alignof(std::max_align_t);
+
+    size_t allocations  = 0;
+    size_t liveBytes    = 0;
+    size_t peakBytes    = 0;
+
+    void* countedAlloc(size_t n) {
+        void* p = std::malloc(n + HEADER);
+        if (!p) throw std::bad_alloc();
+        *static_cast<size_t*>(p) = n;
+        allocations++;
+        liveBytes += n;
+        if (liveBytes > peakBytes) peakBytes = liveBytes;
+        return static_cast<char*>(p) + HEADER;
+    }
+
+    void countedFree(void* p) noexcept {
+        if (!p) return;
+        void* block = static_cast<char*>(p) - HEADER;
+        liveBytes -= *static_cast<size_t*>(block);
+        std::free(block);
+    }
+
+    // Allocation counters over one run.
+    struct HeapProbe {
+        size_t startAllocs  = allocations;
+        size_t startLive    = liveBytes;
+
+        HeapProbe() { peakBytes = liveBytes; }
+
+        size_t allocs() const   { return allocations - startAllocs; }
+        size_t peak() const     { return peakBytes - startLive; }
+    };
+}
+
+void* operator new(size_t n)                        { return countedAlloc(n); }
+void* operator new[](size_t n)                      { return countedAlloc(n); }
+void operator delete(void* p) noexcept              { countedFree(p); }
+void operator delete[](void* p) noexcept            { countedFree(p); }
+void operator delete(void* p, size_t) noexcept      { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept    { countedFree(p); }
+
+namespace {
+    using namespace HMS;
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string filter;
+        std::string corpusDir   = HMS_JSON_BENCH_CORPUS_DIR;
+        double      minTime     = 0.5;
+    };
+
+    struct Result {
+        double  seconds = 0;
+        size_t  allocs  = 0;
+        size_t  peak    = 0;
+    };
+
+    std::string load(const Options& opt, const bench::CorpusFile& file) {
+        std::string path = opt.corpusDir + "/" + file.name;
+        std::ifstream in(path, std::ios::binary);
+        if (in) {
+            std::ostringstream ss;
+            ss << in.rdbuf();
+            return ss.str();
+        }
+        std::string text = file.generate();
+        std::ofstream out(path, std::ios::binary);
+        if (!out.write(text.data(), static_cast<std::streamsize>(text.size()))) {
+            std::fprintf(stderr, "note: could not write %s, using the corpus in memory\n", path.c_str());
+        }
+        return text;
+    }
+
+    // Runs op until minTime has passed (at least twice) and keeps the fastest run.
+    template<typename Op>
+    Result measure(const Options& opt, Op op) {
+        Result r;
+        {
+            HeapProbe probe;
+            op();
+            r.allocs    = probe.allocs();
+            r.peak      = probe.peak();
+        }
+        double best     = 1e30;
+        double total    = 0;
+        for (int runs = 0; runs < 2 || total < opt.minTime; ++runs) {
+            auto t0 = Clock::now();
+            op();
+            double s = std::chrono::duration<double>(Clock::now() - t0).count();
+            total += s;
+            if (s < best) best = s;
+        }
+        r.seconds = best;
+        return r;
+    }
+
+    void report(const std::string& name, size_t bytes, const Result& r) {
+        std::printf("%-32s %10.3f ms %10.1f %12zu %12zu\n", name.c_str(), r.seconds * 1e3, bytes / r.seconds / 1e6, r.allocs, r.peak / 1024);
+    }
+
+    bool parse(std::string_view text, JsonValue& out) {
+        #if HMS_JSON_EXCEPTIONS_ENABLED
+            try {
+                out = deserialize(text);
+            } catch (const ParseError& e) {
+                std::fprintf(stderr, "parse error: %s\n", e.what());
+                return false;
+            }
+        #else
+            ParseError err;
+            out = deserialize(text, err);
+            if (err) {
+                std::fprintf(stderr, "parse error: %s\n", err.what.c_str());
+                return false;
+            }
+        #endif
+        return true;
+    }
+
+    void parseInto(JsonDocument& doc, std::string_view text) {
+        #if HMS_JSON_EXCEPTIONS_ENABLED
+            doc.parse(text);
+        #else
+            ParseError err;
+            doc.parse(text, err);
+        #endif
+    }
+
+    bool selected(const Options& opt, const std::string& name) {
+        return opt.filter.empty() || name.find(opt.filter) != std::string::npos;
+    }
+
+    bool readOptions(int argc, char** argv, Options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            const char* a = argv[i];
+            if (std::strncmp(a, "--benchmark_filter=", 19) == 0)            opt.filter      = a + 19;
+            else if (std::strncmp(a, "--benchmark_min_time=", 21) == 0)     opt.minTime     = std::atof(a + 21);
+            else if (std::strncmp(a, "--corpus_dir=", 13) == 0)             opt.corpusDir   = a + 13;
+            else {
+                std::fprintf(stderr, "usage: %s [--benchmark_filter=<substring>] [--benchmark_min_time=<seconds>] [--corpus_dir=<dir>]\n", argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!readOptions(argc, argv, opt)) return 2;
+
+    #ifdef NDEBUG
+        const char* build = "release";
+    #else
+        const char* build = "debug";
+    #endif
+    std::printf("HMS_JSON %s, %s build\n", HMS_JSON_EXCEPTIONS_ENABLED ? "exceptions" : "no exceptions", build);
+    std::printf("%-32s %13s %10s %12s %12s\n", "Benchmark", "Time", "MB/s", "Allocs", "Peak KiB");
+
+    for (const bench::CorpusFile& file : bench::corpus()) {
+        std::string base = file.name;
+        base = base.substr(0, base.find('.'));
+        bool wanted = false;
+        for (const char* op : { "parse/", "parse_arena/", "serialize/", "serialize_pretty/" }) wanted |= selected(opt, op + base);
+        if (!wanted) continue;
+
+        std::string text = load(opt, file);
+        JsonValue tree;
+        if (!parse(text, tree)) return 1;
+
+        if (selected(opt, "parse/" + base)) {
+            report("parse/" + base, text.size(), measure(opt, [&] { JsonValue v; parse(text, v); }));
+        }
+        if (selected(opt, "parse_arena/" + base)) {
+            JsonDocument doc;
+            report("parse_arena/" + base, text.size(), measure(opt, [&] { parseInto(doc, text); }));
+        }
+        if (selected(opt, "serialize/" + base)) {
+            size_t bytes = serialize(tree).size();
+            report("serialize/" + base, bytes, measure(opt, [&] { std::string s = serialize(tree); }));
+        }
+        if (selected(opt, "serialize_pretty/" + base)) {
+            size_t bytes = serialize(tree, true).size();
+            report("serialize_pretty/" + base, bytes, measure(opt, [&] { std::string s = serialize(tree, true); }));
+        }
+    }
+    return 0;
+}
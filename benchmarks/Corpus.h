@@ -0,0 +1,188 @@
+#ifndef HMS_JSON_BENCH_CORPUS_H
+#define HMS_JSON_BENCH_CORPUS_H
+
+/*
+ * Synthetic stand-ins for the usual JSON benchmark files. They are generated from a fixed seed,
+ * so every machine benchmarks the same bytes, and written to the corpus directory the first time
+ * they are needed. Delete the directory to regenerate them after changing a generator.
+ */
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace HMS {
+    namespace bench {
+        struct CorpusFile {
+            const char* name;
+            std::string (*generate)();
+        };
+
+        class Gen {
+            public:
+                explicit Gen(uint32_t seed) : rng(seed) {}
+
+                uint32_t below(uint32_t n)              { return static_cast<uint32_t>(rng() % n); }
+                bool chance(uint32_t percent)           { return below(100) < percent; }
+
+                std::string word() {
+                    static const char* const words[] = {
+                        "json", "parser", "sensor", "value", "stream", "embedded", "fast", "node", "tree", "buffer",
+                        "arena", "token", "index", "thread", "cache", "vector", "string", "number", "object", "array"
+                    };
+                    return words[below(20)];
+                }
+
+                std::string sentence(uint32_t words) {
+                    std::string s;
+                    for (uint32_t i = 0; i < words; ++i) {
+                        if (i) s += ' ';
+                        s += word();
+                    }
+                    return s;
+                }
+
+                // Mostly ASCII with some multi byte UTF-8 and characters that need escaping.
+                std::string text(uint32_t words) {
+                    static const char* const extras[] = { "caf\xc3\xa9", "\xe6\x97\xa5\xe6\x9c\xac", "\\\"quoted\\\"", "line\\nbreak", "\\u00e9t\\u00e9", "\xf0\x9f\x98\x80" };
+                    std::string s;
+                    for (uint32_t i = 0; i < words; ++i) {
+                        if (i) s += ' ';
+                        s += chance(10) ? extras[below(6)] : word();
+                    }
+                    return s;
+                }
+
+                std::string quoted(const std::string& s)    { return '"' + s + '"'; }
+
+                // Shortest digits are not the point here, the corpus only needs realistic lengths.
+                std::string decimal(double v, int digits) {
+                    char buf[64];
+                    std::snprintf(buf, sizeof buf, "%.*f", digits, v);
+                    return buf;
+                }
+
+            private:
+                std::mt19937 rng;
+        };
+
+        // Social media timeline: mid sized objects, many string fields, nulls and large integer ids.
+        inline std::string twitter() {
+            Gen g(1);
+            std::string s = "{\"statuses\":[";
+            for (int i = 0; i < 800; ++i) {
+                if (i) s += ',';
+                uint64_t id = 505874924095815681ull + static_cast<uint64_t>(i) * 7919u;
+                s += "{\"metadata\":{\"result_type\":\"recent\",\"iso_language_code\":\"ja\"},";
+                s += "\"created_at\":\"Sun Aug 31 00:29:15 +0000 2014\",\"id\":" + std::to_string(id) + ",\"id_str\":\"" + std::to_string(id) + "\",";
+                s += "\"text\":" + g.quoted(g.text(8 + g.below(16))) + ",";
+                s += "\"source\":\"<a href=\\\"https://mobile.example.com\\\" rel=\\\"nofollow\\\">Mobile Web</a>\",\"truncated\":false,";
+                s += "\"in_reply_to_status_id\":" + std::string(g.chance(30) ? std::to_string(id - 11) : "null") + ",\"in_reply_to_screen_name\":null,";
+                s += "\"user\":{\"id\":" + std::to_string(1186275104u + g.below(100000)) + ",\"name\":" + g.quoted(g.text(2)) + ",\"screen_name\":" + g.quoted(g.word() + std::to_string(i));
+                s += ",\"location\":\"\",\"description\":" + g.quoted(g.text(10 + g.below(10))) + ",\"url\":null,\"protected\":false";
+                s += ",\"followers_count\":" + std::to_string(g.below(5000)) + ",\"friends_count\":" + std::to_string(g.below(3000));
+                s += ",\"listed_count\":" + std::to_string(g.below(40)) + ",\"created_at\":\"Mon Feb 04 12:40:08 +0000 2013\",\"favourites_count\":" + std::to_string(g.below(900));
+                s += ",\"utc_offset\":null,\"time_zone\":null,\"geo_enabled\":" + std::string(g.chance(20) ? "true" : "false") + ",\"verified\":false";
+                s += ",\"profile_background_color\":\"C0DEED\",\"profile_image_url\":\"http://pbs.example.com/profile_images/" + std::to_string(id % 100000) + "/normal.jpeg\"";
+                s += ",\"default_profile\":true,\"following\":false,\"notifications\":false},";
+                s += "\"geo\":null,\"coordinates\":null,\"place\":null,\"retweet_count\":" + std::to_string(g.below(100)) + ",\"favorite_count\":" + std::to_string(g.below(50)) + ",";
+                s += "\"entities\":{\"hashtags\":[";
+                for (uint32_t h = 0, n = g.below(3); h < n; ++h) s += std::string(h ? "," : "") + "{\"text\":" + g.quoted(g.word()) + ",\"indices\":[" + std::to_string(h * 10) + "," + std::to_string(h * 10 + 7) + "]}";
+                s += "],\"symbols\":[],\"urls\":[],\"user_mentions\":[]},\"favorited\":false,\"retweeted\":false,\"lang\":\"ja\"}";
+            }
+            s += "],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,\"query\":\"%E4%B8%80\",\"count\":800,\"since_id\":0}}";
+            return s;
+        }
+
+        // Event catalogue: objects keyed by numeric strings, many small integer arrays and repeated keys.
+        inline std::string citm() {
+            Gen g(2);
+            std::string s = "{\"areaNames\":{";
+            for (int i = 0; i < 200; ++i) s += std::string(i ? "," : "") + "\"" + std::to_string(205705993 + i) + "\":" + g.quoted(g.sentence(2 + g.below(3)));
+            s += "},\"audienceSubCategoryNames\":{\"337100890\":\"Abonn\xc3\xa9\"},\"events\":{";
+            for (int i = 0; i < 1200; ++i) {
+                std::string id = std::to_string(138586341 + i * 3);
+                s += std::string(i ? "," : "") + "\"" + id + "\":{\"description\":null,\"id\":" + id + ",\"logo\":" + (g.chance(40) ? "\"/images/UE0AAAAACEKo6QAAAAZDSVRN\"" : "null");
+                s += ",\"name\":" + g.quoted(g.sentence(3 + g.below(5))) + ",\"subTopicIds\":[";
+                for (uint32_t t = 0, n = 1 + g.below(5); t < n; ++t) s += std::string(t ? "," : "") + std::to_string(337184262 + g.below(200));
+                s += "],\"subjectCode\":null,\"subtitle\":null,\"topicIds\":[" + std::to_string(324846099 + g.below(20)) + "," + std::to_string(107888604 + g.below(20)) + "]}";
+            }
+            s += "},\"performances\":[";
+            for (int i = 0; i < 1500; ++i) {
+                s += std::string(i ? "," : "") + "{\"eventId\":" + std::to_string(138586341 + g.below(1200) * 3) + ",\"id\":" + std::to_string(339887544 + i) + ",\"logo\":null,\"name\":null,\"prices\":[";
+                for (uint32_t p = 0, n = 1 + g.below(4); p < n; ++p) {
+                    s += std::string(p ? "," : "") + "{\"amount\":" + std::to_string(9000 + g.below(200) * 500) + ",\"audienceSubCategoryId\":337100890,\"seatCategoryId\":" + std::to_string(338937295 + p) + "}";
+                }
+                s += "],\"seatCategories\":[";
+                for (uint32_t c = 0, n = 1 + g.below(4); c < n; ++c) {
+                    s += std::string(c ? "," : "") + "{\"areas\":[";
+                    for (uint32_t a = 0, m = 1 + g.below(6); a < m; ++a) s += std::string(a ? "," : "") + "{\"areaId\":" + std::to_string(205705993 + g.below(200)) + ",\"blockIds\":[]}";
+                    s += "],\"seatCategoryId\":" + std::to_string(338937295 + c) + "}";
+                }
+                s += "],\"seatMapImage\":null,\"start\":" + std::to_string(1372701600000ull + static_cast<uint64_t>(i) * 86400000u) + ",\"venueCode\":\"PLEYEL_PLEYEL\"}";
+            }
+            s += "],\"venueNames\":{\"PLEYEL_PLEYEL\":\"Salle Pleyel\"}}";
+            return s;
+        }
+
+        // Geographic outline: nearly all bytes are coordinates with 15 fractional digits.
+        inline std::string canada() {
+            Gen g(3);
+            std::string s = "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\",\"properties\":{\"name\":\"Canada\"},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[";
+            double lon = -65.613616999999977, lat = 43.420273000000009;
+            for (int ring = 0; ring < 120; ++ring) {
+                s += ring ? ",[" : "[";
+                for (int p = 0; p < 480; ++p) {
+                    lon += (static_cast<int>(g.below(2001)) - 1000) * 1e-5;
+                    lat += (static_cast<int>(g.below(2001)) - 1000) * 1e-5;
+                    s += std::string(p ? "," : "") + "[" + g.decimal(lon, 15) + "," + g.decimal(lat, 15) + "]";
+                }
+                s += "]";
+            }
+            s += "]}}]}";
+            return s;
+        }
+
+        // Documents that stress recursion: many branches nested a few hundred levels deep.
+        inline std::string deep() {
+            Gen g(4);
+            std::string s = "[";
+            for (int i = 0; i < 400; ++i) {
+                if (i) s += ',';
+                int depth = 100 + static_cast<int>(g.below(200));
+                for (int d = 0; d < depth; ++d) s += (d & 1) ? "[" : "{\"n\":";
+                s += std::to_string(i);
+                for (int d = depth - 1; d >= 0; --d) s += (d & 1) ? "]" : "}";
+            }
+            s += "]";
+            return s;
+        }
+
+        // Few large string values, the string scanner and escape decoder dominate.
+        inline std::string strings() {
+            Gen g(5);
+            std::string s = "{\"documents\":[";
+            for (int i = 0; i < 48; ++i) {
+                std::string body;
+                while (body.size() < 40000) body += g.text(12) + (g.chance(30) ? "\\n" : " ");
+                s += std::string(i ? "," : "") + "{\"title\":" + g.quoted(g.sentence(4)) + ",\"body\":" + g.quoted(body) + "}";
+            }
+            s += "]}";
+            return s;
+        }
+
+        inline const std::vector<CorpusFile>& corpus() {
+            static const std::vector<CorpusFile> files = {
+                { "twitter.json",   twitter },
+                { "citm.json",      citm    },
+                { "canada.json",    canada  },
+                { "deep.json",      deep    },
+                { "strings.json",   strings },
+            };
+            return files;
+        }
+    }
+}
+
+#endif // HMS_JSON_BENCH_CORPUS_H
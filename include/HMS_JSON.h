@@ -29,21 +29,57 @@
 #ifndef HMS_JSON_H
 #define HMS_JSON_H
 
+#include "HMS_JSON_Bind.h"
+#include "HMS_JSON_Cbor.h"
+#include "HMS_JSON_File.h"
+#include "HMS_JSON_Lazy.h"
+#include "HMS_JSON_Lines.h"
+#include "HMS_JSON_Stats.h"
 #include "HMS_JSON_Value.h"
+#include "HMS_JSON_Stream.h"
+#include "HMS_JSON_Writer.h"
+#include "HMS_JSON_Document.h"
 #include "HMS_JSON_Serializer.h"
 #include "HMS_JSON_Exceptions.h"
 #include "HMS_JSON_Deserializer.h"
 
 namespace HMS {
     #if HMS_JSON_EXCEPTIONS_ENABLED
-        inline JsonValue deserialize(const std::string& s) { return JsonDeserializer::deserialize(s); }
+        inline JsonValue deserialize(std::string_view s)                               { return JsonDeserializer::deserialize(s); }
+        inline JsonValue deserialize(const char* data, size_t len)                     { return JsonDeserializer::deserialize(data, len); }
+        inline void deserialize(std::string_view s, JsonSaxHandler& handler)           { JsonDeserializer::parse(s, handler); }
     #else
-        inline JsonValue deserialize(const std::string& s, ParseError& err) { return JsonDeserializer::deserialize(s, err); }
+        inline JsonValue deserialize(std::string_view s, ParseError& err)              { return JsonDeserializer::deserialize(s, err); }
+        inline JsonValue deserialize(const char* data, size_t len, ParseError& err)    { return JsonDeserializer::deserialize(data, len, err); }
+        inline bool deserialize(std::string_view s, JsonSaxHandler& h, ParseError& err) { return JsonDeserializer::parse(s, h, err); }
     #endif
 
+    /*
+     * Same result as deserialize(), but the members of a large top level array or object are parsed
+     * concurrently on up to `threads` threads (0 = all hardware threads). When one member holds most
+     * of the document, as in {"records":[...]}, the members of its value are split instead. Inputs
+     * below HMS_JSON_PARALLEL_MIN_SIZE, scalar documents and calls made inside a JsonArenaScope are
+     * parsed on the calling thread. Malformed input is reparsed serially, so errors are identical too.
+     */
+    #if HMS_JSON_EXCEPTIONS_ENABLED
+        inline JsonValue deserializeParallel(std::string_view s, unsigned threads = 0) { return JsonDeserializer::deserializeParallel(s, threads); }
+    #else
+        inline JsonValue deserializeParallel(std::string_view s, ParseError& err, unsigned threads = 0) {
+            return JsonDeserializer::deserializeParallel(s, err, threads);
+        }
+    #endif
+
+    // Cursor over src that parses only what is accessed; src has to outlive it.
+    inline JsonLazyValue deserializeLazy(std::string_view src)                         { return JsonLazyValue(src); }
+
     inline std::string serialize(const JsonValue& v, bool pretty=false, int indent=2) {
         return JsonSerializer::toString(v, pretty, indent);
     }
+
+    // serialize() with large arrays and objects written on up to `threads` threads, same output.
+    inline std::string serializeParallel(const JsonValue& v, bool pretty=false, int indent=2, unsigned threads=0) {
+        return JsonSerializer::toStringParallel(v, pretty, indent, threads);
+    }
 }
 
 #endif // HMS_JSON_H
@@ -0,0 +1,126 @@
+#ifndef HMS_JSON_ARENA_H
+#define HMS_JSON_ARENA_H
+
+#include "HMS_JSON_Config.h"
+#include "HMS_JSON_Stats.h"
+
+namespace HMS {
+    /*
+     * Monotonic bump allocator backing a JsonDocument. Allocations are never freed one by one,
+     * release() drops every chunk at once. When constructed over a caller supplied buffer the
+     * buffer is used first and heap chunks are only requested once it is exhausted.
+     */
+    class JsonArena {
+        public:
+            static constexpr size_t DEFAULT_CHUNK_SIZE  = 4096;
+            static constexpr size_t MAX_CHUNK_SIZE      = 64 * 1024;
+
+            explicit JsonArena(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+            JsonArena(void* buffer, size_t size, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+            ~JsonArena();
+
+            JsonArena(const JsonArena&)             = delete;
+            JsonArena& operator=(const JsonArena&)  = delete;
+
+            void* allocate(size_t bytes, size_t align) {
+                size_t skew = reinterpret_cast<uintptr_t>(cursor) & (align - 1);
+                size_t pad  = skew ? align - skew : 0;
+                if (cursor && static_cast<size_t>(limit - cursor) >= bytes + pad) {
+                    unsigned char* p = cursor + pad;
+                    cursor = p + bytes;
+                    used += bytes + pad;
+                    return p;
+                }
+                return allocateSlow(bytes, align);
+            }
+
+            void release();
+
+            size_t bytesUsed()  const { return used;            }   // bytes handed out since the last release()
+            size_t heapBytes()  const { return heap;            }   // bytes currently held in heap chunks
+
+            static JsonArena* current() { return active; }
+
+        private:
+            struct Chunk {
+                Chunk*  next;
+                size_t  size;
+            };
+
+            unsigned char*  cursor      = nullptr;
+            unsigned char*  limit       = nullptr;
+            Chunk*          chunks      = nullptr;
+            void*           buffer      = nullptr;
+            size_t          bufferSize  = 0;
+            size_t          chunkSize   = DEFAULT_CHUNK_SIZE;
+            size_t          nextChunk   = DEFAULT_CHUNK_SIZE;
+            size_t          used        = 0;
+            size_t          heap        = 0;
+
+            inline static thread_local JsonArena* active = nullptr;
+
+            void* allocateSlow(size_t bytes, size_t align);
+
+            friend class JsonArenaScope;
+    };
+
+    /*
+     * While a scope is alive, containers created on this thread (by JsonDeserializer, getObject(),
+     * getArray() and the operator[] builders) take their memory from the given arena. Scopes nest.
+     */
+    class JsonArenaScope {
+        public:
+            explicit JsonArenaScope(JsonArena& arena) : previous(JsonArena::active) { JsonArena::active = &arena; }
+            // Suspends the active arena, containers go to the heap until the scope ends.
+            explicit JsonArenaScope(std::nullptr_t)   : previous(JsonArena::active) { JsonArena::active = nullptr; }
+            ~JsonArenaScope() { JsonArena::active = previous; }
+
+            JsonArenaScope(const JsonArenaScope&)               = delete;
+            JsonArenaScope& operator=(const JsonArenaScope&)    = delete;
+
+        private:
+            JsonArena* previous;
+    };
+
+    /*
+     * Allocator used by JsonArray / JsonObject. It binds to the arena active at construction time
+     * (or the heap when there is none) and keeps that binding for the container's lifetime, so
+     * nodes added later through operator[] land next to their siblings.
+     */
+    template<typename T>
+    class JsonAllocator {
+        public:
+            using value_type                                = T;
+            using propagate_on_container_swap               = std::true_type;
+            using propagate_on_container_move_assignment    = std::true_type;
+            using propagate_on_container_copy_assignment    = std::false_type;
+
+            JsonAllocator() noexcept                            : arena(JsonArena::current())   {}
+            explicit JsonAllocator(JsonArena* a) noexcept       : arena(a)                      {}
+            template<typename U>
+            JsonAllocator(const JsonAllocator<U>& other) noexcept : arena(other.arena)          {}
+
+            T* allocate(size_t n) {
+                HMS_JSON_STATS_ADD(allocations, 1);
+                HMS_JSON_STATS_ADD(allocatedBytes, n * sizeof(T));
+                if (arena) return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+                return std::allocator<T>().allocate(n);
+            }
+
+            void deallocate(T* p, size_t n) noexcept {
+                if (!arena) std::allocator<T>().deallocate(p, n);
+            }
+
+            // Copies of a tree are placed wherever the copying code currently allocates.
+            JsonAllocator select_on_container_copy_construction() const { return JsonAllocator(); }
+
+            JsonArena* arena;
+    };
+
+    template<typename T, typename U>
+    bool operator==(const JsonAllocator<T>& a, const JsonAllocator<U>& b) { return a.arena == b.arena; }
+    template<typename T, typename U>
+    bool operator!=(const JsonAllocator<T>& a, const JsonAllocator<U>& b) { return a.arena != b.arena; }
+}
+
+#endif // HMS_JSON_ARENA_H
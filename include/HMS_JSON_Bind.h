@@ -0,0 +1,319 @@
+#ifndef HMS_JSON_BIND_H
+#define HMS_JSON_BIND_H
+
+#include "HMS_JSON_Writer.h"
+#include "HMS_JSON_Deserializer.h"
+
+#include <map>
+#include <limits>
+#include <tuple>
+#include <optional>
+
+namespace HMS {
+    /*
+     * Pull parser behind the struct bindings: the caller asks for the value it expects next and
+     * gets it straight out of the input, no JsonValue is built. Every call returns false once
+     * parsing failed (exception builds throw instead), errors carry the same messages and positions
+     * as JsonDeserializer. Custom JsonBind specializations use it like this:
+     *
+     *      if (!r.beginObject()) return false;
+     *      std::string_view key;
+     *      for (bool end; r.nextMember(key, end) && !end; ) { ...read or r.skip()... }
+     *
+     * Keys are only valid until the next call.
+     */
+    class JsonReader {
+        public:
+            #if HMS_JSON_EXCEPTIONS_ENABLED
+                explicit JsonReader(std::string_view src);
+            #else
+                JsonReader(std::string_view src, ParseError& err_out);
+            #endif
+
+            JsonReader(const JsonReader&)               = delete;
+            JsonReader& operator=(const JsonReader&)    = delete;
+
+            bool beginObject();
+            bool nextMember(std::string_view& key, bool& end);      // end is set at '}', which is consumed
+            bool beginArray();
+            bool nextElement(bool& end);                            // end is set at ']', which is consumed
+
+            bool readNull(bool& wasNull);                           // consumes a null, leaves anything else
+            bool read(bool& out);
+            bool read(double& out);
+            bool read(int64_t& out);                                // also 1.0, 1e3, -0; not 1.5
+            bool read(uint64_t& out);
+            bool read(std::string& out);
+            bool read(JsonValue& out);
+            bool skip();                                            // checks and drops the next value
+            bool finish();                                          // nothing but whitespace may follow
+
+            // Reports msg at the start of the value read last, e.g. for a failed range check.
+            bool fail(const char* msg);
+
+        private:
+            JsonDeserializer        deser;
+            std::vector<uint32_t>   tokens;
+            size_t                  valueAt = 0;
+            bool                    first   = true;                 // nothing read yet in the innermost container
+
+            char peek() const { return deser.pos < deser.string.size() ? deser.string[deser.pos] : '\0'; }
+            bool expect(bool ok, const char* msg);
+    };
+
+    /*
+     * Maps a C++ type to JSON: write() emits it through a JsonWriter, read() fills it from a
+     * JsonReader. Provided for bool, arithmetic types, std::string, JsonValue, std::vector,
+     * std::optional (null when empty), std::map with string keys and every struct declared with
+     * HMS_JSON_DEFINE; specialize it for anything else.
+     */
+    template<typename T, typename Enable = void>
+    struct JsonBind;
+
+    namespace detail {
+        template<typename C, typename M>
+        struct JsonField {
+            std::string_view    name;
+            M C::*              member;
+        };
+
+        template<typename C, typename M>
+        constexpr JsonField<C, M> jsonField(std::string_view name, M C::* member) { return JsonField<C, M>{name, member}; }
+
+        template<typename T, typename = void>
+        struct HasJsonFields : std::false_type {};
+
+        template<typename T>
+        struct HasJsonFields<T, std::void_t<decltype(hmsJsonFields(static_cast<const T*>(nullptr)))>> : std::true_type {};
+
+        template<typename T, typename Wide>
+        bool readInteger(JsonReader& r, T& out) {
+            Wide w;
+            if (!r.read(w)) return false;
+            if (w < static_cast<Wide>(std::numeric_limits<T>::min()) || w > static_cast<Wide>(std::numeric_limits<T>::max())) {
+                return r.fail("Number out of range");
+            }
+            out = static_cast<T>(w);
+            return true;
+        }
+    }
+
+    template<>
+    struct JsonBind<bool> {
+        static void write(JsonWriter& w, bool v)                { w.value(v); }
+        static bool read(JsonReader& r, bool& v)                { return r.read(v); }
+    };
+
+    template<typename T>
+    struct JsonBind<T, std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value>> {
+        static void write(JsonWriter& w, T v)                   { w.value(static_cast<long long>(v)); }
+        static bool read(JsonReader& r, T& v)                   { return detail::readInteger<T, int64_t>(r, v); }
+    };
+
+    template<typename T>
+    struct JsonBind<T, std::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value && !std::is_same<T, bool>::value>> {
+        static void write(JsonWriter& w, T v)                   { w.value(static_cast<unsigned long long>(v)); }
+        static bool read(JsonReader& r, T& v)                   { return detail::readInteger<T, uint64_t>(r, v); }
+    };
+
+    template<typename T>
+    struct JsonBind<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+        static void write(JsonWriter& w, T v)                   { w.value(static_cast<double>(v)); }
+        static bool read(JsonReader& r, T& v) {
+            double d;
+            if (!r.read(d)) return false;
+            if (d < -static_cast<double>(std::numeric_limits<T>::max()) || d > static_cast<double>(std::numeric_limits<T>::max())) {
+                return r.fail("Number out of range");
+            }
+            v = static_cast<T>(d);
+            return true;
+        }
+    };
+
+    template<>
+    struct JsonBind<std::string> {
+        static void write(JsonWriter& w, const std::string& v)  { w.value(v); }
+        static bool read(JsonReader& r, std::string& v)         { return r.read(v); }
+    };
+
+    template<>
+    struct JsonBind<JsonValue> {
+        static void write(JsonWriter& w, const JsonValue& v)    { w.value(v); }
+        static bool read(JsonReader& r, JsonValue& v)           { return r.read(v); }
+    };
+
+    template<typename T, typename A>
+    struct JsonBind<std::vector<T, A>> {
+        static void write(JsonWriter& w, const std::vector<T, A>& v) {
+            w.beginArray();
+            for (const T& e : v) JsonBind<T>::write(w, e);
+            w.endArray();
+        }
+
+        static bool read(JsonReader& r, std::vector<T, A>& v) {
+            if (!r.beginArray()) return false;
+            v.clear();
+            for (bool end; r.nextElement(end); ) {
+                if (end) return true;
+                v.emplace_back();
+                if (!JsonBind<T>::read(r, v.back())) return false;
+            }
+            return false;
+        }
+    };
+
+    template<typename T>
+    struct JsonBind<std::optional<T>> {
+        static void write(JsonWriter& w, const std::optional<T>& v) {
+            if (v) JsonBind<T>::write(w, *v);
+            else w.value(nullptr);
+        }
+
+        static bool read(JsonReader& r, std::optional<T>& v) {
+            bool wasNull;
+            if (!r.readNull(wasNull)) return false;
+            if (wasNull) { v.reset(); return true; }
+            if (!v) v.emplace();
+            return JsonBind<T>::read(r, *v);
+        }
+    };
+
+    template<typename T, typename C, typename A>
+    struct JsonBind<std::map<std::string, T, C, A>> {
+        static void write(JsonWriter& w, const std::map<std::string, T, C, A>& v) {
+            w.beginObject();
+            for (const auto& kv : v) {
+                w.key(kv.first);
+                JsonBind<T>::write(w, kv.second);
+            }
+            w.endObject();
+        }
+
+        // The first of duplicate keys wins, like in a parsed JsonObject.
+        static bool read(JsonReader& r, std::map<std::string, T, C, A>& v) {
+            if (!r.beginObject()) return false;
+            v.clear();
+            std::string_view key;
+            for (bool end; r.nextMember(key, end); ) {
+                if (end) return true;
+                auto slot = v.emplace(std::string(key), T{});
+                if (!(slot.second ? JsonBind<T>::read(r, slot.first->second) : r.skip())) return false;
+            }
+            return false;
+        }
+    };
+
+    // Structs declared with HMS_JSON_DEFINE. Keys are matched by length first and memcmp second,
+    // unknown members are skipped, missing ones keep their current value and a repeated key
+    // overwrites the earlier one.
+    template<typename T>
+    struct JsonBind<T, std::enable_if_t<detail::HasJsonFields<T>::value>> {
+        static void write(JsonWriter& w, const T& v) {
+            static constexpr auto fields = hmsJsonFields(static_cast<const T*>(nullptr));
+            w.beginObject();
+            std::apply([&](const auto&... f) {
+                ((w.key(f.name), JsonBind<std::decay_t<decltype(v.*(f.member))>>::write(w, v.*(f.member))), ...);
+            }, fields);
+            w.endObject();
+        }
+
+        static bool read(JsonReader& r, T& v) {
+            static constexpr auto fields = hmsJsonFields(static_cast<const T*>(nullptr));
+            if (!r.beginObject()) return false;
+            std::string_view key;
+            for (bool end; r.nextMember(key, end); ) {
+                if (end) return true;
+                bool ok     = true;
+                bool found  = std::apply([&](const auto&... f) {
+                    return ((f.name.size() == key.size() && std::memcmp(f.name.data(), key.data(), key.size()) == 0
+                             && (ok = JsonBind<std::decay_t<decltype(v.*(f.member))>>::read(r, v.*(f.member)), true)) || ...);
+                }, fields);
+                if (!(found ? ok : r.skip())) return false;
+            }
+            return false;
+        }
+    };
+
+    // Writes v compactly or pretty printed, without building a JsonValue.
+    template<typename T>
+    void toJson(const T& v, JsonSink& sink, bool pretty=false, int indent=2) {
+        JsonWriter w(sink, pretty, indent);
+        JsonBind<T>::write(w, v);
+    }
+
+    template<typename T>
+    std::string toJson(const T& v, bool pretty=false, int indent=2) {
+        std::string out;
+        JsonStringSink sink(out);
+        toJson(v, sink, pretty, indent);
+        return out;
+    }
+
+    // Parses src straight into out, see JsonBind for how the members are matched.
+    #if HMS_JSON_EXCEPTIONS_ENABLED
+        template<typename T>
+        void fromJson(std::string_view src, T& out) {
+            JsonReader r(src);
+            JsonBind<T>::read(r, out);
+            r.finish();
+        }
+    #else
+        template<typename T>
+        bool fromJson(std::string_view src, T& out, ParseError& err_out) {
+            JsonReader r(src, err_out);
+            return JsonBind<T>::read(r, out) && r.finish();
+        }
+    #endif
+}
+
+#define HMS_JSON_EXPAND(x) x
+#define HMS_JSON_FIELD(T, f) ::HMS::detail::jsonField(#f, &T::f)
+#define HMS_JSON_EACH_1(M, T, a) M(T, a)
+#define HMS_JSON_EACH_2(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_1(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_3(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_2(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_4(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_3(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_5(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_4(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_6(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_5(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_7(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_6(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_8(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_7(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_9(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_8(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_10(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_9(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_11(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_10(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_12(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_11(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_13(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_12(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_14(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_13(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_15(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_14(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_16(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_15(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_17(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_16(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_18(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_17(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_19(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_18(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_20(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_19(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_21(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_20(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_22(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_21(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_23(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_22(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_24(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_23(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_25(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_24(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_26(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_25(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_27(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_26(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_28(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_27(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_29(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_28(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_30(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_29(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_31(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_30(M, T, __VA_ARGS__))
+#define HMS_JSON_EACH_32(M, T, a, ...) M(T, a), HMS_JSON_EXPAND(HMS_JSON_EACH_31(M, T, __VA_ARGS__))
+#define HMS_JSON_PICK(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, N, ...) N
+#define HMS_JSON_EACH(M, T, ...) HMS_JSON_EXPAND(HMS_JSON_PICK(__VA_ARGS__, HMS_JSON_EACH_32, HMS_JSON_EACH_31, HMS_JSON_EACH_30, HMS_JSON_EACH_29, HMS_JSON_EACH_28, HMS_JSON_EACH_27, HMS_JSON_EACH_26, HMS_JSON_EACH_25, HMS_JSON_EACH_24, HMS_JSON_EACH_23, HMS_JSON_EACH_22, HMS_JSON_EACH_21, HMS_JSON_EACH_20, HMS_JSON_EACH_19, HMS_JSON_EACH_18, HMS_JSON_EACH_17, HMS_JSON_EACH_16, HMS_JSON_EACH_15, HMS_JSON_EACH_14, HMS_JSON_EACH_13, HMS_JSON_EACH_12, HMS_JSON_EACH_11, HMS_JSON_EACH_10, HMS_JSON_EACH_9, HMS_JSON_EACH_8, HMS_JSON_EACH_7, HMS_JSON_EACH_6, HMS_JSON_EACH_5, HMS_JSON_EACH_4, HMS_JSON_EACH_3, HMS_JSON_EACH_2, HMS_JSON_EACH_1)(M, T, __VA_ARGS__))
+
+/*
+ * Binds the listed public members of a struct to JSON object members of the same name (up to 32).
+ * Use it at namespace scope in the struct's namespace, after its definition:
+ *
+ *      struct Reading { std::string id; double value; std::vector<int> flags; };
+ *      HMS_JSON_DEFINE(Reading, id, value, flags)
+ *
+ *      std::string text = HMS::toJson(reading);
+ *      HMS::fromJson(text, reading);
+ */
+#define HMS_JSON_DEFINE(Type, ...) \
+    constexpr auto hmsJsonFields(const Type*) { return std::make_tuple(HMS_JSON_EACH(HMS_JSON_FIELD, Type, __VA_ARGS__)); }
+
+#endif // HMS_JSON_BIND_H
@@ -0,0 +1,41 @@
+#ifndef HMS_JSON_CBOR_H
+#define HMS_JSON_CBOR_H
+
+#include "HMS_JSON_Value.h"
+#include "HMS_JSON_Sink.h"
+#include "HMS_JSON_Exceptions.h"
+
+#ifndef HMS_JSON_CBOR_MAX_DEPTH
+#define HMS_JSON_CBOR_MAX_DEPTH 512     // nested arrays and maps decode() accepts before failing
+#endif
+
+namespace HMS {
+    /*
+     * CBOR (RFC 8949) codec for JsonValue, a compact binary alternative to the text format for
+     * links between devices. encode() uses the preferred serialization: the shortest integer
+     * heads, and doubles as half or single precision floats whenever that is exact. Integers and
+     * floats keep their kind, so JSON text -> CBOR -> JSON text is lossless.
+     *
+     *      std::vector<uint8_t> bytes = JsonCbor::encode(v);
+     *      JsonValue back = JsonCbor::decode(bytes.data(), bytes.size());
+     *
+     * decode() also accepts indefinite length strings, arrays and maps, skips tags and reads
+     * undefined as null. Byte strings, map keys other than text and the remaining simple values
+     * have no JSON equivalent and are rejected, as is nesting deeper than HMS_JSON_CBOR_MAX_DEPTH.
+     * Errors report line 1 and the 1 based byte offset as
+     * the column.
+     */
+    class JsonCbor {
+        public:
+            static void encode(const JsonValue& v, JsonSink& sink);
+            static std::vector<uint8_t> encode(const JsonValue& v);
+
+            #if HMS_JSON_EXCEPTIONS_ENABLED
+                static JsonValue decode(const uint8_t* data, size_t len);
+            #else
+                static JsonValue decode(const uint8_t* data, size_t len, ParseError& err_out);
+            #endif
+    };
+}
+
+#endif // HMS_JSON_CBOR_H
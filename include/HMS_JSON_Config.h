@@ -1,8 +1,16 @@
 #ifndef HMS_JSON_CONFIG_H
 #define HMS_JSON_CONFIG_H
 
+#ifndef HMS_JSON_ENABLE_EXCEPTIONS          // or build with -DHMS_JSON_ENABLE_EXCEPTIONS for the throwing API
 #define HMS_JSON_NO_EXCEPTIONS
-
+#endif
+// #define HMS_JSON_ORDERED_OBJECTS         // JsonObject keeps insertion order in a flat vector instead of a std::map
+// #define HMS_JSON_NO_SIMD                 // disable the SSE2/AVX2 kernels on x86-64 desktop builds
+// #define HMS_JSON_NO_AVX2                 // keep the SSE2 kernels but never dispatch to AVX2
+// #define HMS_JSON_NO_IOSTREAM             // drop the std::ostream overloads and the <ostream> dependency
+// #define HMS_JSON_NO_THREADS              // run the parallel readers and writers on the calling thread only
+// #define HMS_JSON_INTERN_KEYS             // object keys become shared JsonKey handles, deduplicated per document
+// #define HMS_JSON_STATS                   // per call counters and timings for parse and serialize, see HMS_JSON_Stats.h
 
 
 #ifndef HMS_JSON_NO_EXCEPTIONS
@@ -11,14 +19,25 @@
 #define HMS_JSON_EXCEPTIONS_ENABLED 0
 #endif
 
+#if !defined(HMS_JSON_NO_THREADS) && defined(__has_include)
+#if !__has_include(<thread>)
+#define HMS_JSON_NO_THREADS
+#endif
+#endif
+
 #include <map>
 #include <cmath>
 #include <string>
 #include <vector>
+#include <memory>
 #include <variant>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#ifndef HMS_JSON_NO_IOSTREAM
 #include <ostream>
-#include <sstream>
+#endif
+#include <string_view>
+#include <type_traits>
 
 #endif // HMS_JSON_CONFIG_H
\ No newline at end of file
@@ -1,57 +1,73 @@
 #ifndef HMS_JSON_DESERIALIZER_H
 #define HMS_JSON_DESERIALIZER_H
 
+#include "HMS_JSON_Sax.h"
 #include "HMS_JSON_Value.h"
 #include "HMS_JSON_Exceptions.h"
 
+#ifndef HMS_JSON_PARALLEL_MIN_SIZE
+#define HMS_JSON_PARALLEL_MIN_SIZE (1u << 20)   // deserializeParallel() parses smaller inputs on the calling thread
+#endif
+
 namespace HMS {
     class JsonDeserializer {
         public:
             #if HMS_JSON_EXCEPTIONS_ENABLED
-                static JsonValue deserialize(const std::string& src);
+                static JsonValue deserialize(std::string_view src);
+                static JsonValue deserialize(const char* data, size_t len);
+                static void parse(std::string_view src, JsonSaxHandler& handler);
+                static JsonValue deserializeParallel(std::string_view src, unsigned threads = 0);
             #else
-                static JsonValue deserialize(const std::string& src, ParseError& err_out);
+                static JsonValue deserialize(std::string_view src, ParseError& err_out);
+                static JsonValue deserialize(const char* data, size_t len, ParseError& err_out);
+                static bool parse(std::string_view src, JsonSaxHandler& handler, ParseError& err_out);
+                static JsonValue deserializeParallel(std::string_view src, ParseError& err_out, unsigned threads = 0);
             #endif
 
-        private:
-            const std::string   string;
-            size_t              pos = 0;
-            ErrorPos            posinfo{1,1};
+            static ErrorPos locate(std::string_view src, size_t offset);
 
-            void advance();
-            char peek() const;
-            void skipWhitespace();
+        private:
+            friend class JsonLazyValue;                 // materializes subtrees in place through parseJsonValue
+            friend class JsonStreamParser;              // decodes escaped string literals with parseString
+            friend class JsonReader;                    // pull interface for the struct bindings
 
-            #if HMS_JSON_EXCEPTIONS_ENABLED
-                void expectChar(char c);
-
-                JsonValue parseBool();
-                JsonValue parseNull();
-                JsonValue parseArray();
-                JsonValue parseString();
-                JsonValue parseObject();
-                JsonValue parseNumber();
-                JsonValue parseJsonValue();
-                JsonValue deserializeInternal();
-                [[noreturn]] void error(const std::string& msg);
-            #else
-                bool expectChar(char c, ParseError& err_out); 
-
-                JsonValue parseBool(ParseError& err_out);
-                JsonValue parseNull(ParseError& err_out);
-                JsonValue parseArray(ParseError& err_out);
-                JsonValue parseString(ParseError& err_out);
-                JsonValue parseObject(ParseError& err_out);
-                JsonValue parseNumber(ParseError& err_out);
-                JsonValue parseJsonValue(ParseError& err_out);
-                JsonValue deserializeInternal(ParseError& err_out);
-                JsonValue parseJsonValueNoexcept(ParseError& err_out);
+            std::string_view    string;                 // borrowed, caller keeps the buffer alive
+            size_t              pos         = 0;
+            const uint32_t*     token       = nullptr;  // structural index from stage one, null when parsing byte by byte
+            const uint32_t*     tokenEnd    = nullptr;
+            bool                utf8Checked = false;    // stage one already validated the whole input
+            #if !HMS_JSON_EXCEPTIONS_ENABLED
+                ParseError*     err         = nullptr;
             #endif
+            std::string         scratch;                // escaped literals decoded for JsonSaxHandler
+
+            void prepare(std::vector<uint32_t>& tokens);
+            char nextToken();
+            bool endOfScalar();
+
+            bool parseBool(JsonValue& out);
+            bool parseNull(JsonValue& out);
+            bool parseArray(JsonValue& out);
+            bool parseObject(JsonValue& out);
+            bool parseNumber(JsonValue& out);
+            bool parseString(std::string& out);
+            bool parseJsonValue(JsonValue& out);
+            bool deserializeInternal(JsonValue& out);
+            bool parseRange(size_t count, JsonObject::key_type* keys, JsonValue* values);
+            bool parseKey(JsonObject::key_type& key);
+            static bool parseMembers(std::string_view slice, size_t count, JsonObject::key_type* keys, JsonValue* values);
+            static bool parseParallel(std::string_view src, unsigned threads, JsonValue& out, unsigned depth = 0);
+            bool saxInternal(JsonSaxHandler& h);
+            bool saxValue(JsonSaxHandler& h);
+            bool saxString(std::string_view& out);
+            bool accepted(bool ok, size_t at);
+            bool error(const std::string& msg);
+            bool error(const std::string& msg, size_t at);
 
-            explicit JsonDeserializer(const std::string& src) : string(src), pos(0) {}
+            explicit JsonDeserializer(std::string_view src) : string(src), pos(0) {}
     };
 
 }
 
 
-#endif // HMS_JSON_DESERIALIZER_H
\ No newline at end of file
+#endif // HMS_JSON_DESERIALIZER_H
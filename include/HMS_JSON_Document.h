@@ -0,0 +1,63 @@
+#ifndef HMS_JSON_DOCUMENT_H
+#define HMS_JSON_DOCUMENT_H
+
+#include "HMS_JSON_Value.h"
+#include "HMS_JSON_Exceptions.h"
+
+namespace HMS {
+    /*
+     * Owns a JSON tree together with the arena its containers are allocated from. Parsing into the
+     * document and building through its operator[] use the arena, so clear() gives back all node
+     * and container memory with one release() instead of a free per node. Chained builders (doc["a"]["b"] = ...) create their inner containers from the arena only
+     * while a scope() is alive, otherwise they fall back to the heap:
+     *
+     *      JsonDocument doc;
+     *      { auto s = doc.scope(); doc["a"]["b"] = 1; }
+     *
+     * Values moved out of the document still point into its arena and must not outlive it,
+     * copies are always safe.
+     */
+    class JsonDocument {
+        public:
+            explicit JsonDocument(size_t chunkSize = JsonArena::DEFAULT_CHUNK_SIZE) : arenaStore(chunkSize) {}
+            /*
+             * The arena starts in the caller's buffer and takes heap chunks once it is full. Only
+             * containers and string boxes are placed in it: object keys and strings too long for
+             * std::string's inline buffer still allocate their characters on the heap, so parsing
+             * into a fixed buffer is not heap free.
+             */
+            JsonDocument(void* buffer, size_t size) : arenaStore(buffer, size) {}
+            ~JsonDocument() { clear(); }
+
+            JsonDocument(const JsonDocument&)               = delete;
+            JsonDocument& operator=(const JsonDocument&)    = delete;
+
+            #if HMS_JSON_EXCEPTIONS_ENABLED
+                void parse(std::string_view src);
+            #else
+                bool parse(std::string_view src, ParseError& err_out);
+            #endif
+
+            JsonValue& operator[](const std::string& key);
+            JsonValue& operator[](std::size_t idx);
+
+            JsonValue& root()                   { return rootValue;     }
+            const JsonValue& root() const       { return rootValue;     }
+            JsonArena& arena()                  { return arenaStore;    }
+            JsonArenaScope scope()              { return JsonArenaScope(arenaStore); }
+
+            // Still runs the destructor of every node before releasing the arena: string and key
+            // characters past std::string's inline buffer, and nodes assigned in from outside a
+            // scope(), live on the heap and have to be freed one by one.
+            void clear();
+
+        private:
+            JsonArena   arenaStore;     // declared first so the tree is destroyed before its memory
+            #ifdef HMS_JSON_INTERN_KEYS
+                JsonKeyTable keys;      // shared by everything parsed into or built through the document
+            #endif
+            JsonValue   rootValue;
+    };
+}
+
+#endif // HMS_JSON_DOCUMENT_H
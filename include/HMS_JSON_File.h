@@ -0,0 +1,83 @@
+#ifndef HMS_JSON_FILE_H
+#define HMS_JSON_FILE_H
+
+#include "HMS_JSON_Lazy.h"
+#include "HMS_JSON_Value.h"
+#include "HMS_JSON_Exceptions.h"
+
+namespace HMS {
+    /*
+     * Read only view of a whole file. On POSIX systems the file is memory mapped so the parser
+     * reads the page cache directly, elsewhere it is read into one heap buffer. Failing to open,
+     * stat, map or read the file is reported as a ParseError at line 1, column 1.
+     */
+    class JsonMappedFile {
+        public:
+            JsonMappedFile() = default;
+            ~JsonMappedFile() { close(); }
+
+            JsonMappedFile(JsonMappedFile&& other) noexcept;
+            JsonMappedFile& operator=(JsonMappedFile&& other) noexcept;
+            JsonMappedFile(const JsonMappedFile&)               = delete;
+            JsonMappedFile& operator=(const JsonMappedFile&)    = delete;
+
+            #if HMS_JSON_EXCEPTIONS_ENABLED
+                void open(const char* path);
+            #else
+                bool open(const char* path, ParseError& err_out);
+            #endif
+            void close();
+
+            std::string_view text() const       { return std::string_view(data, size); }
+            bool isMapped() const               { return mapped; }
+
+        private:
+            const char*             data    = nullptr;
+            size_t                  size    = 0;
+            bool                    mapped  = false;
+            std::unique_ptr<char[]> buffer;             // fallback when mapping is not available
+
+            bool load(const char* path, std::string& why);
+    };
+
+    enum class JsonFileMode {
+        Tree,       // parse the whole file into root()
+        Lazy,       // only map it, read through lazy() on demand
+    };
+
+    /*
+     * A parsed file, or in Lazy mode a file kept mapped for on-demand access. Tree mode unmaps
+     * the file once root() holds the parsed tree, text() and lazy() are then empty. Peak memory
+     * of that parse is the mapping, the tree and the structural index of 4 bytes per token.
+     * In Lazy mode nothing is parsed up front: lazy() walks the mapped text and its raw() views
+     * and key lookups point straight into the file. The mapping stays alive as long as this
+     * object, cursors must not outlive it.
+     */
+    class JsonFile {
+        public:
+            #if HMS_JSON_EXCEPTIONS_ENABLED
+                void open(const char* path, JsonFileMode mode = JsonFileMode::Tree);
+            #else
+                bool open(const char* path, ParseError& err_out)                     { return open(path, JsonFileMode::Tree, err_out); }
+                bool open(const char* path, JsonFileMode mode, ParseError& err_out);
+            #endif
+
+            JsonValue& root()                   { return rootValue; }
+            const JsonValue& root() const       { return rootValue; }
+            JsonLazyValue lazy() const          { return JsonLazyValue(source.text()); }
+            std::string_view text() const       { return source.text(); }
+            const JsonMappedFile& file() const  { return source; }
+
+        private:
+            JsonMappedFile  source;
+            JsonValue       rootValue;
+    };
+
+    #if HMS_JSON_EXCEPTIONS_ENABLED
+        JsonFile deserializeFile(const char* path, JsonFileMode mode = JsonFileMode::Tree);
+    #else
+        JsonFile deserializeFile(const char* path, ParseError& err_out, JsonFileMode mode = JsonFileMode::Tree);
+    #endif
+}
+
+#endif // HMS_JSON_FILE_H
@@ -0,0 +1,164 @@
+#ifndef HMS_JSON_KEY_H
+#define HMS_JSON_KEY_H
+
+#include "HMS_JSON_Config.h"
+#include <cstring>
+
+#ifdef HMS_JSON_INTERN_KEYS
+#include <atomic>
+#endif
+
+namespace HMS {
+    namespace detail {
+        // FNV-1a over the key bytes, the hash every object index and key table agrees on.
+        inline size_t keyHash(std::string_view key) {
+            uint32_t h = 2166136261u;
+            for (unsigned char c : key) { h ^= c; h *= 16777619u; }
+            return h;
+        }
+
+        // Keys that carry their hash already.
+        template<typename K>
+        size_t keyHash(const K& key, decltype(key.hash())* = nullptr) { return key.hash(); }
+    }
+
+    #ifdef HMS_JSON_INTERN_KEYS
+        class JsonKey;
+
+        namespace detail {
+            template<typename S>
+            struct IsKeyText : std::integral_constant<bool, std::is_convertible<const S&, std::string_view>::value && !std::is_same<S, JsonKey>::value> {};
+        }
+
+        /*
+         * Object key when HMS_JSON_INTERN_KEYS is defined: a pointer to shared, reference counted
+         * key text. Keys created while a JsonKeyTable is active on the thread come from that table,
+         * so each distinct key is stored once and equal keys compare by pointer; otherwise the key
+         * owns its own copy. Keys are immutable and safe to share between threads.
+         */
+        class JsonKey {
+            public:
+                JsonKey() noexcept = default;                               // the empty key
+                JsonKey(const char* s)                                      : JsonKey(std::string_view(s)) {}
+                JsonKey(const std::string& s)                               : JsonKey(std::string_view(s)) {}
+                explicit JsonKey(std::string_view s);
+
+                JsonKey(const JsonKey& other) noexcept                      : rep(other.rep) { retain(); }
+                JsonKey(JsonKey&& other) noexcept                           : rep(other.rep) { other.rep = nullptr; }
+                ~JsonKey()                                                  { release(); }
+
+                JsonKey& operator=(const JsonKey& other) noexcept {
+                    if (rep != other.rep) { other.retain(); release(); rep = other.rep; }
+                    return *this;
+                }
+
+                JsonKey& operator=(JsonKey&& other) noexcept {
+                    if (this != &other) { release(); rep = other.rep; other.rep = nullptr; }
+                    return *this;
+                }
+
+                const char* data()      const { return rep ? rep->text : ""; }
+                const char* c_str()     const { return data(); }
+                size_t size()           const { return rep ? rep->size : 0; }
+                bool empty()            const { return !rep; }
+                size_t hash()           const { return rep ? rep->hash : detail::keyHash(std::string_view()); }
+                std::string str()       const { return std::string(data(), size()); }
+                std::string_view view() const { return std::string_view(data(), size()); }
+                operator std::string_view() const { return view(); }
+
+                friend bool operator==(const JsonKey& a, const JsonKey& b) {
+                    return a.rep == b.rep || (a.size() == b.size() && a.hash() == b.hash() && std::memcmp(a.data(), b.data(), a.size()) == 0);
+                }
+                friend bool operator!=(const JsonKey& a, const JsonKey& b) { return !(a == b); }
+                friend bool operator<(const JsonKey& a, const JsonKey& b)  { return a.rep != b.rep && a.view() < b.view(); }
+
+                // Text comparisons take anything viewable as a string without building a key.
+                template<typename S, typename = std::enable_if_t<detail::IsKeyText<S>::value>>
+                friend bool operator==(const JsonKey& a, const S& b)        { return a.view() == std::string_view(b); }
+                template<typename S, typename = std::enable_if_t<detail::IsKeyText<S>::value>>
+                friend bool operator==(const S& a, const JsonKey& b)        { return std::string_view(a) == b.view(); }
+                template<typename S, typename = std::enable_if_t<detail::IsKeyText<S>::value>>
+                friend bool operator!=(const JsonKey& a, const S& b)        { return a.view() != std::string_view(b); }
+                template<typename S, typename = std::enable_if_t<detail::IsKeyText<S>::value>>
+                friend bool operator!=(const S& a, const JsonKey& b)        { return std::string_view(a) != b.view(); }
+                template<typename S, typename = std::enable_if_t<detail::IsKeyText<S>::value>>
+                friend bool operator<(const JsonKey& a, const S& b)         { return a.view() < std::string_view(b); }
+                template<typename S, typename = std::enable_if_t<detail::IsKeyText<S>::value>>
+                friend bool operator<(const S& a, const JsonKey& b)         { return std::string_view(a) < b.view(); }
+
+            private:
+                struct Rep {
+                    std::atomic<uint32_t>   refs;
+                    uint32_t                size;
+                    uint32_t                hash;
+                    char                    text[1];                        // size bytes and a terminator
+                };
+
+                Rep* rep = nullptr;
+
+                static Rep* make(std::string_view s, size_t hash);
+                void retain() const     { if (rep) rep->refs.fetch_add(1, std::memory_order_relaxed); }
+                void release();
+
+                friend class JsonKeyTable;
+        };
+
+        /*
+         * Deduplicating store for JsonKey. While a JsonKeyScope over it is alive every key created
+         * on this thread, by the parsers and by operator[] alike, is looked up here first. The
+         * parsers set up a table of their own for each document unless one is active already, so
+         * install one around a series of parses to share keys between documents as well. Keys keep
+         * their text alive after the table is gone.
+         */
+        class JsonKeyTable {
+            public:
+                JsonKeyTable() = default;
+                ~JsonKeyTable() = default;
+
+                JsonKeyTable(const JsonKeyTable&)               = delete;
+                JsonKeyTable& operator=(const JsonKeyTable&)    = delete;
+
+                JsonKey intern(std::string_view s);
+                size_t size() const             { return count; }
+                void clear()                    { slots.clear(); count = 0; }
+
+                static JsonKeyTable* current()  { return active; }
+
+            private:
+                std::vector<JsonKey>    slots;                              // open addressing, the empty key marks a free slot
+                size_t                  count   = 0;
+
+                inline static thread_local JsonKeyTable* active = nullptr;
+
+                void grow();
+
+                friend class JsonKeyScope;
+        };
+
+        class JsonKeyScope {
+            public:
+                explicit JsonKeyScope(JsonKeyTable& table) : previous(JsonKeyTable::active) { JsonKeyTable::active = &table; }
+                ~JsonKeyScope() { JsonKeyTable::active = previous; }
+
+                JsonKeyScope(const JsonKeyScope&)               = delete;
+                JsonKeyScope& operator=(const JsonKeyScope&)    = delete;
+
+            private:
+                JsonKeyTable* previous;
+        };
+
+        namespace detail {
+            // Table for the duration of one parse, unless the caller has one active already.
+            class ParseKeyScope {
+                public:
+                    ParseKeyScope() : scope(JsonKeyTable::current() ? *JsonKeyTable::current() : table) {}
+
+                private:
+                    JsonKeyTable table;
+                    JsonKeyScope scope;
+            };
+        }
+    #endif
+}
+
+#endif // HMS_JSON_KEY_H
@@ -0,0 +1,95 @@
+#ifndef HMS_JSON_LAZY_H
+#define HMS_JSON_LAZY_H
+
+#include "HMS_JSON_Value.h"
+#include "HMS_JSON_Exceptions.h"
+
+namespace HMS {
+    /*
+     * Read only cursor over unparsed JSON text. Navigating with operator[] only scans forward to the
+     * requested member or element and skips everything else with a bracket and quote aware scan, a
+     * value is parsed when one of the as*() or materialize() calls touches it:
+     *
+     *      JsonLazyValue doc(text);
+     *      double rssi = doc["device"]["rssi"].asNumber();
+     *
+     * Skipped subtrees are only checked for terminated strings and balanced brackets, whatever is
+     * materialized goes through the full parser. A failed lookup does not throw, it yields a cursor
+     * with exists() == false that carries the reason until a value is requested from it. Text after
+     * the root value makes the root itself a failed cursor, finding it costs the constructor one skip
+     * over the whole text. The cursor borrows the text, which has to outlive it.
+     */
+    class JsonLazyValue {
+        public:
+            JsonLazyValue() = default;
+            explicit JsonLazyValue(std::string_view src);
+
+            bool exists()    const { return state == Ok; }
+            bool isNull()    const { return peek() == 'n'; }
+            bool isBool()    const { return peek() == 't' || peek() == 'f'; }
+            bool isArray()   const { return peek() == '['; }
+            bool isNumber()  const { char c = peek(); return c == '-' || (c >= '0' && c <= '9'); }
+            bool isString()  const { return peek() == '"'; }
+            bool isObject()  const { return peek() == '{'; }
+
+            JsonLazyValue operator[](std::string_view key) const;
+            JsonLazyValue operator[](std::size_t idx) const;
+            JsonLazyValue operator[](const char* key) const { return (*this)[std::string_view(key)]; }
+            JsonLazyValue operator[](int idx) const;
+
+            // Members or elements of an object or array, 0 for anything else.
+            std::size_t size() const;
+
+            // Iteration without indexing from the front every time: first() is the first member or
+            // element, next() the one after this cursor, both return a missing cursor at the end.
+            // key() decodes the member name for cursors reached through an object.
+            JsonLazyValue first() const;
+            JsonLazyValue next() const;
+            std::string key() const;
+
+            // Unparsed text of the value, e.g. to hand a subtree to another consumer.
+            std::string_view raw() const;
+
+            #if HMS_JSON_EXCEPTIONS_ENABLED
+                JsonValue materialize() const;
+                bool asBool() const;
+                double asNumber() const;
+                int64_t asInt64() const;
+                uint64_t asUInt64() const;
+                std::string asString() const;
+            #else
+                JsonValue materialize(ParseError& err_out) const;
+                bool asBool(ParseError& err_out) const;
+                double asNumber(ParseError& err_out) const;
+                int64_t asInt64(ParseError& err_out) const;
+                uint64_t asUInt64(ParseError& err_out) const;
+                std::string asString(ParseError& err_out) const;
+            #endif
+
+        private:
+            enum State : uint8_t { Ok, Missing, Malformed };
+            enum Parent : uint8_t { Root, InArray, InObject };
+
+            std::string_view    src;
+            size_t              at          = 0;                // value start, or where the lookup failed
+            size_t              keyAt       = 0;                // opening quote of the member name, InObject only
+            State               state       = Missing;
+            Parent              parent      = Root;
+            const char*         reason      = "Value not found";
+
+            JsonLazyValue(std::string_view s, size_t a, size_t k, Parent p) : src(s), at(a), keyAt(k), state(Ok), parent(p), reason(nullptr) {}
+            JsonLazyValue fail(State s, const char* why, size_t where) const;
+            JsonLazyValue member(size_t p) const;
+            JsonLazyValue element(size_t p) const;
+
+            char peek() const { return state == Ok ? src[at] : '\0'; }
+            bool keyEquals(std::string_view key) const;
+            bool decodeKey(std::string& out) const;
+            bool load(JsonValue& out, ParseError* err) const;
+            bool loadAs(JsonValue& out, bool (JsonValue::*is)() const, const char* expected, ParseError* err) const;
+            bool report(const char* msg, size_t where, ParseError* err) const;
+    };
+
+}
+
+#endif // HMS_JSON_LAZY_H
@@ -0,0 +1,71 @@
+#ifndef HMS_JSON_LINES_H
+#define HMS_JSON_LINES_H
+
+#include "HMS_JSON_Value.h"
+#include "HMS_JSON_Sink.h"
+#include "HMS_JSON_Exceptions.h"
+
+#ifndef HMS_JSON_LINES_BATCH
+#define HMS_JSON_LINES_BATCH 4096       // records parsed in parallel before they are handed out
+#endif
+
+namespace HMS {
+    /*
+     * Reader for newline delimited JSON (NDJSON / JSON Lines): one document per line, blank lines
+     * are skipped. Records are parsed in batches across the library's thread pool and handed out
+     * in input order, either all at once or one by one to a callback that returns false to stop:
+     *
+     *      JsonLinesReader reader;                     // all hardware threads
+     *      reader.forEach(log, [&](JsonValue& rec, size_t line) { ...; return true; });
+     *
+     * The first malformed record ends the run with its error, line numbers refer to the whole
+     * input, records before it have been delivered. Records always live on the heap: some batches
+     * are parsed on the calling thread, and the caller's JsonArenaScope is suspended around them.
+     */
+    class JsonLinesReader {
+        public:
+            explicit JsonLinesReader(unsigned threads = 0) : threads(threads) {}
+
+            #if HMS_JSON_EXCEPTIONS_ENABLED
+                std::vector<JsonValue> parseAll(std::string_view src);
+
+                template<typename Fn>
+                void forEach(std::string_view src, Fn&& fn)                     { run(src, &visit<Fn>, context(fn), nullptr); }
+            #else
+                std::vector<JsonValue> parseAll(std::string_view src, ParseError& err_out);
+
+                template<typename Fn>
+                bool forEach(std::string_view src, Fn&& fn, ParseError& err_out) {
+                    err_out = ParseError{};
+                    return run(src, &visit<Fn>, context(fn), &err_out);
+                }
+            #endif
+
+        private:
+            using Visitor = bool (*)(void* ctx, JsonValue& record, size_t line);
+
+            unsigned threads;
+
+            template<typename Fn>
+            static void* context(Fn& fn)                    { return const_cast<void*>(static_cast<const void*>(&fn)); }
+
+            template<typename Fn>
+            static bool visit(void* ctx, JsonValue& record, size_t line) { return (*static_cast<std::remove_reference_t<Fn>*>(ctx))(record, line); }
+
+            bool run(std::string_view src, Visitor visitor, void* ctx, ParseError* err);
+    };
+
+    // Writes each value compactly on its own line.
+    class JsonLinesWriter {
+        public:
+            explicit JsonLinesWriter(JsonSink& sink) : out(sink) {}
+
+            JsonLinesWriter& write(const JsonValue& v);
+            void flush()                                    { out.flush(); }
+
+        private:
+            JsonOutput out;
+    };
+}
+
+#endif // HMS_JSON_LINES_H
@@ -0,0 +1,164 @@
+#ifndef HMS_JSON_OBJECT_H
+#define HMS_JSON_OBJECT_H
+
+#include "HMS_JSON_Arena.h"
+#include "HMS_JSON_Key.h"
+#if HMS_JSON_EXCEPTIONS_ENABLED
+#include <stdexcept>
+#endif
+
+#ifndef HMS_JSON_OBJECT_LINEAR_LIMIT
+#define HMS_JSON_OBJECT_LINEAR_LIMIT 16         // objects up to this size are searched linearly, larger ones get a hash index
+#endif
+
+namespace HMS {
+    /*
+     * Insertion ordered object stored as one contiguous vector of key/value pairs. Small objects are
+     * searched with a linear scan; past HMS_JSON_OBJECT_LINEAR_LIMIT members an open addressing index
+     * of member positions is kept alongside. The interface mirrors the std::map subset used with
+     * JsonObject. Keys must not be modified through iterators. K is std::string, or JsonKey with
+     * HMS_JSON_INTERN_KEYS.
+     */
+    template<typename V, typename K = std::string>
+    class BasicJsonOrderedObject {
+        public:
+            using key_type          = K;
+            using mapped_type       = V;
+            using value_type        = std::pair<K, V>;
+            using allocator_type    = JsonAllocator<value_type>;
+            using size_type         = size_t;
+            using iterator          = typename std::vector<value_type, allocator_type>::iterator;
+            using const_iterator    = typename std::vector<value_type, allocator_type>::const_iterator;
+
+            iterator begin()                        { return entries.begin();   }
+            iterator end()                          { return entries.end();     }
+            const_iterator begin()  const           { return entries.begin();   }
+            const_iterator end()    const           { return entries.end();     }
+            const_iterator cbegin() const           { return entries.cbegin();  }
+            const_iterator cend()   const           { return entries.cend();    }
+
+            size_t size()   const                   { return entries.size();    }
+            bool   empty()  const                   { return entries.empty();   }
+            void   reserve(size_t n)                { entries.reserve(n);       }
+            void   clear()                          { entries.clear(); index.clear(); }
+
+            allocator_type get_allocator() const    { return entries.get_allocator(); }
+
+            iterator find(std::string_view key) {
+                size_t i = lookup(key);
+                return i == npos ? entries.end() : entries.begin() + static_cast<std::ptrdiff_t>(i);
+            }
+
+            const_iterator find(std::string_view key) const {
+                size_t i = lookup(key);
+                return i == npos ? entries.end() : entries.begin() + static_cast<std::ptrdiff_t>(i);
+            }
+
+            size_t count(std::string_view key)      const { return lookup(key) == npos ? 0 : 1; }
+            bool   contains(std::string_view key)   const { return lookup(key) != npos;         }
+
+            V& at(std::string_view key)             { return entries[checked(key)].second;      }
+            const V& at(std::string_view key) const { return entries[checked(key)].second;      }
+
+            V& operator[](std::string_view key) {
+                size_t i = lookup(key);
+                if (i != npos) return entries[i].second;
+                return append(K(key), V{})->second;
+            }
+
+            // Like std::map::emplace, an existing key is left untouched.
+            template<typename Key, typename... Args>
+            std::pair<iterator, bool> emplace(Key&& key, Args&&... args) {
+                size_t i = lookup(probe(key));
+                if (i != npos) return { entries.begin() + static_cast<std::ptrdiff_t>(i), false };
+                return { append(K(std::forward<Key>(key)), V(std::forward<Args>(args)...)), true };
+            }
+
+            std::pair<iterator, bool> insert(value_type&& kv) {
+                return emplace(std::move(kv.first), std::move(kv.second));
+            }
+
+            std::pair<iterator, bool> insert(const value_type& kv) {
+                return emplace(kv.first, kv.second);
+            }
+
+            iterator erase(const_iterator pos) {
+                iterator it = entries.erase(pos);
+                rebuildIndex();
+                return it;
+            }
+
+            size_t erase(std::string_view key) {
+                size_t i = lookup(key);
+                if (i == npos) return 0;
+                erase(entries.cbegin() + static_cast<std::ptrdiff_t>(i));
+                return 1;
+            }
+
+        private:
+            static constexpr size_t npos = static_cast<size_t>(-1);
+
+            std::vector<value_type, allocator_type>             entries;
+            std::vector<uint32_t, JsonAllocator<uint32_t>>      index;      // slot -> member position + 1, 0 = empty
+
+            // A key of the stored type is looked up as is, so interned keys compare by pointer.
+            static const K& probe(const K& key)                             { return key; }
+            template<typename Key>
+            static std::string_view probe(const Key& key)                   { return std::string_view(key); }
+
+            template<typename Key>
+            size_t lookup(const Key& key) const {
+                if (index.empty()) {
+                    for (size_t i = 0; i < entries.size(); ++i) {
+                        if (entries[i].first.size() == key.size() && entries[i].first == key) return i;
+                    }
+                    return npos;
+                }
+                size_t mask = index.size() - 1;
+                for (size_t slot = detail::keyHash(key) & mask; index[slot]; slot = (slot + 1) & mask) {
+                    const K& k = entries[index[slot] - 1].first;
+                    if (k.size() == key.size() && k == key) return index[slot] - 1;
+                }
+                return npos;
+            }
+
+            size_t checked(std::string_view key) const {
+                size_t i = lookup(key);
+                if (i == npos) {
+                    #if HMS_JSON_EXCEPTIONS_ENABLED
+                        throw std::out_of_range("JSON object has no such key");
+                    #else
+                        std::abort();
+                    #endif
+                }
+                return i;
+            }
+
+            iterator append(K&& key, V&& value) {
+                entries.emplace_back(std::move(key), std::move(value));
+                if (entries.size() > HMS_JSON_OBJECT_LINEAR_LIMIT) {
+                    if (entries.size() * 2 > index.size()) rebuildIndex();
+                    else insertIndex(entries.size() - 1);
+                }
+                return entries.end() - 1;
+            }
+
+            void insertIndex(size_t i) {
+                size_t mask = index.size() - 1;
+                size_t slot = detail::keyHash(entries[i].first) & mask;
+                while (index[slot]) slot = (slot + 1) & mask;
+                index[slot] = static_cast<uint32_t>(i + 1);
+            }
+
+            void rebuildIndex() {
+                index.clear();
+                if (entries.size() <= HMS_JSON_OBJECT_LINEAR_LIMIT) return;
+                size_t slots = 64;
+                while (slots < entries.size() * 4) slots *= 2;
+                index.assign(slots, 0);
+                for (size_t i = 0; i < entries.size(); ++i) insertIndex(i);
+            }
+    };
+}
+
+#endif // HMS_JSON_OBJECT_H
@@ -0,0 +1,33 @@
+#ifndef HMS_JSON_SAX_H
+#define HMS_JSON_SAX_H
+
+#include "HMS_JSON_Config.h"
+
+namespace HMS {
+    /*
+     * Callbacks for event based parsing with JsonDeserializer::parse, no JsonValue is built. Every
+     * callback returns whether parsing should go on, returning false stops it with a ParseError.
+     * The views handed to onString and onKey are only valid during the call: they point into the
+     * input when the literal has no escapes and into a scratch buffer otherwise.
+     *
+     * Integers arrive through onInteger/onUnsigned, which forward to onNumber unless overridden.
+     */
+    class JsonSaxHandler {
+        public:
+            virtual ~JsonSaxHandler() = default;
+
+            virtual bool onNull()                           { return true; }
+            virtual bool onBool(bool)                       { return true; }
+            virtual bool onNumber(double)                   { return true; }
+            virtual bool onInteger(int64_t v)               { return onNumber(static_cast<double>(v)); }
+            virtual bool onUnsigned(uint64_t v)             { return onNumber(static_cast<double>(v)); }
+            virtual bool onString(std::string_view)         { return true; }
+            virtual bool onStartObject()                    { return true; }
+            virtual bool onKey(std::string_view)            { return true; }
+            virtual bool onEndObject()                      { return true; }
+            virtual bool onStartArray()                     { return true; }
+            virtual bool onEndArray()                       { return true; }
+    };
+}
+
+#endif // HMS_JSON_SAX_H
@@ -2,17 +2,45 @@
 #define HMS_JSON_SERIALIZER_H
 
 #include "HMS_JSON_Value.h"
+#include "HMS_JSON_Sink.h"
+
+#ifndef HMS_JSON_PARALLEL_MIN_ELEMENTS
+#define HMS_JSON_PARALLEL_MIN_ELEMENTS 4096     // serializeParallel() writes smaller containers on one thread
+#endif
 
 namespace HMS {
     class JsonSerializer {
         public:
             static std::string toString(const JsonValue& v, bool pretty=false, int indent=2);
-            static void serialize(const JsonValue& v, std::ostream& out, bool pretty=false, int indent=2);
+            static void serializeTo(const JsonValue& v, std::string& out, bool pretty=false, int indent=2);         // replaces out, keeps its capacity
+            static void serializeTo(const JsonValue& v, std::vector<char>& out, bool pretty=false, int indent=2);
+            static void serialize(const JsonValue& v, JsonSink& sink, bool pretty=false, int indent=2);
+
+            // Exact output length in bytes, nothing is allocated.
+            static size_t measure(const JsonValue& v, bool pretty=false, int indent=2);
+            // Writes at most cap bytes (no terminator) and returns the full length like snprintf:
+            // a result greater than cap means the output was truncated.
+            static size_t serializeInto(const JsonValue& v, char* buf, size_t cap, bool pretty=false, int indent=2);
+            #ifndef HMS_JSON_NO_IOSTREAM
+                static void serialize(const JsonValue& v, std::ostream& out, bool pretty=false, int indent=2);
+            #endif
+
+            // Byte for byte the output of serialize(), but the children of every array or object with
+            // at least HMS_JSON_PARALLEL_MIN_ELEMENTS of them are written into separate buffers on up
+            // to `threads` threads (0 = all hardware threads) and then passed to the sink in order.
+            static void serializeParallel(const JsonValue& v, JsonSink& sink, bool pretty=false, int indent=2, unsigned threads=0);
+            static std::string toStringParallel(const JsonValue& v, bool pretty=false, int indent=2, unsigned threads=0);
+
+            // Token emitters shared with the other writers in the library
+            static void writeString(JsonOutput& out, std::string_view s);
+            static void writeDouble(JsonOutput& out, double d);
+            static void writeInteger(JsonOutput& out, int64_t i);
+            static void writeInteger(JsonOutput& out, uint64_t u);
+            static void writeValue(JsonOutput& out, const JsonValue& v, bool pretty=false, int indent=2, int level=0);  // level: depth for pretty indentation
 
         private:
-            static std::string escape(const std::string& s);
-            static void serializeInternal(const JsonValue& v, std::ostream& out, bool pretty, int indent, int level);
+            static void serializeInternal(const JsonValue& v, JsonOutput& out, bool pretty, int indent, int level, unsigned threads=1);
     };
 }
 
-#endif // HMS_JSON_SERIALIZER_H
\ No newline at end of file
+#endif // HMS_JSON_SERIALIZER_H
@@ -0,0 +1,157 @@
+#ifndef HMS_JSON_SINK_H
+#define HMS_JSON_SINK_H
+
+#include "HMS_JSON_Config.h"
+#include <cstring>
+
+#ifndef HMS_JSON_OUTPUT_BUFFER_SIZE
+#define HMS_JSON_OUTPUT_BUFFER_SIZE 256         // bytes gathered on the stack before a sink write
+#endif
+static_assert(HMS_JSON_OUTPUT_BUFFER_SIZE >= 32, "HMS_JSON_OUTPUT_BUFFER_SIZE must hold the 32 bytes reserved for a formatted number");
+
+namespace HMS {
+    // Destination for serialized bytes. Writers batch their output, so write() sees chunks rather
+    // than single tokens.
+    class JsonSink {
+        public:
+            virtual ~JsonSink() = default;
+            virtual void write(const char* data, size_t len) = 0;
+    };
+
+    class JsonStringSink : public JsonSink {
+        public:
+            explicit JsonStringSink(std::string& out) : out(out) {}
+            void write(const char* data, size_t len) override { out.append(data, len); }
+
+        private:
+            std::string& out;
+    };
+
+    class JsonVectorSink : public JsonSink {
+        public:
+            explicit JsonVectorSink(std::vector<char>& out) : out(out) {}
+            void write(const char* data, size_t len) override { out.insert(out.end(), data, data + len); }
+
+        private:
+            std::vector<char>& out;
+    };
+
+    // Counts bytes without storing them.
+    class JsonCountingSink : public JsonSink {
+        public:
+            void write(const char*, size_t len) override { count += len; }
+            size_t size() const { return count; }
+
+        private:
+            size_t count = 0;
+    };
+
+    // Fills a caller owned buffer; bytes past its capacity are counted but dropped.
+    class JsonFixedBufferSink : public JsonSink {
+        public:
+            JsonFixedBufferSink(char* buf, size_t cap) : buf(buf), cap(cap) {}
+
+            void write(const char* data, size_t len) override {
+                if (count < cap) std::memcpy(buf + count, data, cap - count < len ? cap - count : len);
+                count += len;
+            }
+
+            size_t size()       const { return count;       }       // bytes the full output needs
+            bool   truncated()  const { return count > cap; }
+
+        private:
+            char*   buf;
+            size_t  cap;
+            size_t  count = 0;
+    };
+
+    // Forwards every chunk to a callable taking (const char* data, size_t len).
+    template<typename Fn>
+    class JsonCallbackSink : public JsonSink {
+        public:
+            explicit JsonCallbackSink(Fn fn) : fn(std::move(fn)) {}
+            void write(const char* data, size_t len) override { fn(data, len); }
+
+        private:
+            Fn fn;
+    };
+
+    template<typename Fn>
+    JsonCallbackSink<typename std::decay<Fn>::type> makeSink(Fn&& fn) {
+        return JsonCallbackSink<typename std::decay<Fn>::type>(std::forward<Fn>(fn));
+    }
+
+    #ifndef HMS_JSON_NO_IOSTREAM
+        class JsonStreamSink : public JsonSink {
+            public:
+                explicit JsonStreamSink(std::ostream& out) : out(out) {}
+                void write(const char* data, size_t len) override { out.write(data, static_cast<std::streamsize>(len)); }
+
+            private:
+                std::ostream& out;
+        };
+    #endif
+
+    /*
+     * Small stack buffer in front of a JsonSink. Tokens are copied into it and handed to the sink
+     * in HMS_JSON_OUTPUT_BUFFER_SIZE chunks; the destructor flushes whatever is left.
+     */
+    class JsonOutput {
+        public:
+            static constexpr size_t BUFFER_SIZE = HMS_JSON_OUTPUT_BUFFER_SIZE;
+
+            explicit JsonOutput(JsonSink& sink) : sink(sink) {}
+            ~JsonOutput() { flush(); }
+
+            JsonOutput(const JsonOutput&)               = delete;
+            JsonOutput& operator=(const JsonOutput&)    = delete;
+
+            void put(char c) {
+                if (used == BUFFER_SIZE) flush();
+                buffer[used++] = c;
+            }
+
+            void write(const char* data, size_t len) {
+                if (len > BUFFER_SIZE - used) {
+                    flush();
+                    if (len >= BUFFER_SIZE) { sink.write(data, len); flushed += len; return; }
+                }
+                std::memcpy(buffer + used, data, len);
+                used += len;
+            }
+
+            void write(std::string_view s) { write(s.data(), s.size()); }
+
+            void fill(char c, size_t n) {
+                while (n) {
+                    if (used == BUFFER_SIZE) flush();
+                    size_t chunk = BUFFER_SIZE - used < n ? BUFFER_SIZE - used : n;
+                    std::memset(buffer + used, c, chunk);
+                    used += chunk;
+                    n -= chunk;
+                }
+            }
+
+            // Room for n contiguous bytes (n <= BUFFER_SIZE), confirmed afterwards with commit().
+            char* reserve(size_t n) {
+                if (n > BUFFER_SIZE - used) flush();
+                return buffer + used;
+            }
+
+            void commit(size_t n) { used += n; }
+
+            void flush() {
+                if (used) { sink.write(buffer, used); flushed += used; used = 0; }
+            }
+
+            size_t bytes() const { return flushed + used; }     // everything written so far
+
+        private:
+            JsonSink&   sink;
+            size_t      used    = 0;
+            size_t      flushed = 0;
+            char        buffer[BUFFER_SIZE];
+    };
+}
+
+#endif // HMS_JSON_SINK_H
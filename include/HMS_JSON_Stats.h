@@ -0,0 +1,63 @@
+#ifndef HMS_JSON_STATS_H
+#define HMS_JSON_STATS_H
+
+#include "HMS_JSON_Config.h"
+
+// Counting points compile to nothing unless HMS_JSON_STATS is defined.
+#ifdef HMS_JSON_STATS
+#define HMS_JSON_STATS_ADD(counter, n)  (::HMS::detail::statsCounters.counter += (n))
+#else
+#define HMS_JSON_STATS_ADD(counter, n)  ((void)0)
+#endif
+
+#ifdef HMS_JSON_STATS
+namespace HMS {
+    /*
+     * What one JsonDeserializer::deserialize() / parse() or JsonSerializer::serialize() call cost,
+     * including the toString() and serializeTo() helpers. Allocations are the requests made for
+     * containers, value boxes and long string buffers, whether served by the heap or an arena.
+     * The parallel, lazy and streaming readers and the parallel writer are not instrumented.
+     *
+     *      void report(const HMS::JsonStats& s, void*) { metrics.observe("json.parse_ns", s.totalNanos); }
+     *      HMS::JsonStats::setCallback(report);
+     */
+    struct JsonStats {
+        enum Operation : uint8_t { Parse, Serialize };
+
+        using Callback = void (*)(const JsonStats& stats, void* user);
+
+        Operation   operation       = Parse;
+        bool        failed          = false;    // parse error, or stopped by the SAX handler
+        size_t      bytes           = 0;        // input size, or bytes written
+        size_t      nodes           = 0;        // values parsed or written
+        size_t      allocations     = 0;
+        size_t      allocatedBytes  = 0;
+        size_t      maxDepth        = 0;        // deepest container nesting, 0 for a lone scalar
+        uint64_t    indexNanos      = 0;        // parse only: building the structural index
+        uint64_t    valueNanos      = 0;        // building the tree or calling the handler, or writing
+        uint64_t    totalNanos      = 0;
+
+        // The last operation that finished on this thread.
+        static const JsonStats& last();
+
+        // Called on the thread that ran the operation, right after it finished, so it has to be
+        // thread safe when several threads parse. It must not throw: a failed parse reports while
+        // its ParseError is in flight. Pass nullptr to remove it.
+        static void setCallback(Callback cb, void* user = nullptr);
+    };
+
+    namespace detail {
+        struct StatsCounters {
+            size_t  allocations     = 0;
+            size_t  allocatedBytes  = 0;
+            size_t  nodes           = 0;
+            size_t  depth           = 0;
+            size_t  maxDepth        = 0;
+        };
+
+        inline thread_local StatsCounters statsCounters;
+    }
+}
+#endif
+
+#endif // HMS_JSON_STATS_H
@@ -0,0 +1,132 @@
+#ifndef HMS_JSON_STREAM_H
+#define HMS_JSON_STREAM_H
+
+#include "HMS_JSON_Sax.h"
+#include "HMS_JSON_Value.h"
+#include "HMS_JSON_Exceptions.h"
+
+namespace HMS {
+    // Handler that assembles the events into a JsonValue, duplicate keys keep their first value
+    // like JsonDeserializer does.
+    class JsonDomBuilder : public JsonSaxHandler {
+        public:
+            JsonValue& result()                             { return root; }
+            void reset();
+
+            bool onNull() override                          { return put(JsonValue(nullptr)); }
+            bool onBool(bool b) override                    { return put(JsonValue(b)); }
+            bool onNumber(double d) override                { return put(JsonValue(d)); }
+            bool onInteger(int64_t i) override              { return put(JsonValue(static_cast<long long>(i))); }
+            bool onUnsigned(uint64_t u) override            { return put(JsonValue(static_cast<unsigned long long>(u))); }
+            bool onString(std::string_view s) override      { return put(JsonValue(std::string(s))); }
+            bool onStartObject() override                   { return open(JsonValue(JsonObject{})); }
+            bool onKey(std::string_view k) override         { key.assign(k.data(), k.size()); return true; }
+            bool onEndObject() override                     { return close(); }
+            bool onStartArray() override                    { return open(JsonValue(JsonArray{})); }
+            bool onEndArray() override                      { return close(); }
+
+        private:
+            JsonValue               root;
+            std::vector<JsonValue*> stack;                  // open containers, stable while their children are built
+            std::string             key;
+            size_t                  skipDepth   = 0;        // inside the value of a duplicate key
+            #ifdef HMS_JSON_INTERN_KEYS
+                JsonKeyTable        keys;                   // the events may come from many feed() calls, no scope spans them
+            #endif
+
+            JsonValue* slot();
+            bool put(JsonValue&& v);
+            bool open(JsonValue&& container);
+            bool close();
+    };
+
+    /*
+     * Resumable parser for input that arrives in pieces, e.g. from a socket or UART. feed() takes
+     * chunks of any size, including ones that split a string, number or escape sequence, and
+     * finish() marks the end of input. Only the nesting stack and a token cut by a chunk boundary
+     * are buffered, never the whole document. Error positions count lines and columns over
+     * everything fed so far.
+     *
+     *      JsonStreamParser parser;                    // or JsonStreamParser parser(myHandler);
+     *      while (size_t n = uart.read(buf, sizeof buf)) parser.feed(buf, n);
+     *      parser.finish();
+     *      JsonValue& v = parser.value();
+     *
+     * After an error every further call reports the same error until reset().
+     */
+    class JsonStreamParser {
+        public:
+            JsonStreamParser() : handler(&builder) {}
+            explicit JsonStreamParser(JsonSaxHandler& h) : handler(&h) {}
+
+            JsonStreamParser(const JsonStreamParser&)               = delete;
+            JsonStreamParser& operator=(const JsonStreamParser&)    = delete;
+
+            #if HMS_JSON_EXCEPTIONS_ENABLED
+                void feed(const char* data, size_t len);
+                void feed(std::string_view chunk)                   { feed(chunk.data(), chunk.size()); }
+                void finish();
+            #else
+                bool feed(const char* data, size_t len, ParseError& err_out);
+                bool feed(std::string_view chunk, ParseError& err_out) { return feed(chunk.data(), chunk.size(), err_out); }
+                bool finish(ParseError& err_out);
+            #endif
+
+            // A complete value has been parsed; finish() may still reject trailing data.
+            bool done() const                   { return state == Done; }
+
+            // Result of the default constructed parser.
+            JsonValue& value()                  { return builder.result(); }
+
+            void reset();
+
+        private:
+            static constexpr uint8_t ESCAPE_START = 5;
+
+            enum State : uint8_t { Value, ArrayFirst, ObjectFirst, Key, Colon, AfterValue, InString, InNumber, InLiteral, Done, Failed };
+
+            JsonDomBuilder      builder;
+            JsonSaxHandler*     handler;
+            State               state           = Value;
+            std::vector<char>   stack;                          // '{' or '[' per open container
+            std::string         raw;                            // start of a token cut by the chunk boundary
+            std::string         scratch;                        // decoded escaped strings
+            const char*         literal         = nullptr;      // "true", "false" or "null" while in InLiteral
+            uint8_t             literalAt       = 0;
+            bool                stringIsKey     = false;
+            uint8_t             escapeBytes     = 0;            // ESCAPE_START after a backslash, then the \u digits left
+            bool                checkDelimiter  = false;        // a number or literal just ended
+
+            size_t              base            = 0;            // offset of the current chunk in the whole input
+            size_t              lineStart       = 0;
+            int                 line            = 1;
+            size_t              tokenStart      = 0;            // where the current string, number or literal began
+            size_t              tokenLineStart  = 0;
+            int                 tokenLine       = 1;
+
+            std::string         failMsg;
+            ErrorPos            failPos;
+            #if !HMS_JSON_EXCEPTIONS_ENABLED
+                ParseError*     err             = nullptr;
+            #endif
+
+            bool consume(const char* data, size_t len);
+            bool end();
+            bool startValue(char c, size_t at);
+            bool emitString(std::string_view text);
+            bool decode(std::string_view text);
+            bool emitNumber(std::string_view text);
+            bool closeContainer(size_t at);
+            void afterValue()                   { state = stack.empty() ? Done : AfterValue; }
+            void beginToken(size_t at)          { tokenStart = base + at; tokenLine = line; tokenLineStart = lineStart; }
+            std::string_view token(const char* data, size_t from, size_t to);
+
+            ErrorPos here(size_t at) const      { return ErrorPos{line, static_cast<int>(base + at - lineStart) + 1}; }
+            ErrorPos inToken(ErrorPos rel) const;
+            bool accepted(bool ok, ErrorPos at);
+            bool fail(const std::string& msg, ErrorPos at);
+            bool failed();
+    };
+}
+
+#endif // HMS_JSON_STREAM_H
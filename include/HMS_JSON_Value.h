@@ -1,66 +1,151 @@
 #ifndef HMS_JSON_VALUE_H
 #define HMS_JSON_VALUE_H
-#include "HMS_JSON_Config.h"
+#include "HMS_JSON_Object.h"
 
 namespace HMS {
     struct JsonValue;
 
-    using JsonArray  = std::vector<JsonValue>;
-    using JsonObject = std::map<std::string, JsonValue>;
+    using JsonArray         = std::vector<JsonValue, JsonAllocator<JsonValue>>;
+    #ifdef HMS_JSON_INTERN_KEYS
+        using JsonOrderedObject = BasicJsonOrderedObject<JsonValue, JsonKey>;
+        using JsonSortedObject  = std::map<JsonKey, JsonValue, std::less<>, JsonAllocator<std::pair<const JsonKey, JsonValue>>>;
+    #else
+        using JsonOrderedObject = BasicJsonOrderedObject<JsonValue>;
+        using JsonSortedObject  = std::map<std::string, JsonValue, std::less<>, JsonAllocator<std::pair<const std::string, JsonValue>>>;
+    #endif
 
-    struct JsonValue {
-        using Variant = std::variant<
-            std::nullptr_t, 
-            bool, double, 
-            std::string, 
-            JsonObject,
-            JsonArray
-        >;
+    #ifdef HMS_JSON_ORDERED_OBJECTS
+        using JsonObject = JsonOrderedObject;
+    #else
+        using JsonObject = JsonSortedObject;
+    #endif
 
-        Variant JsonVariant;
+    /*
+     * A JSON node in 16 bytes: a one byte type tag next to an 8 byte payload. Null, booleans and
+     * numbers are stored inline; strings, objects and arrays live in a separately allocated box,
+     * taken from the active arena like the containers themselves, and the node only holds a
+     * pointer to it. An array of numbers therefore costs 16 bytes per element.
+     */
+    struct JsonValue {
+        enum class Type : uint8_t { Null, Bool, Double, Int64, UInt64, String, Object, Array };
 
         // Constructors
-        JsonValue()                             : JsonVariant(nullptr)                      {}
-        JsonValue(int i)                        : JsonVariant(static_cast<double>(i))       {}
-        JsonValue(bool b)                       : JsonVariant(b)                            {}
-        JsonValue(double d)                     : JsonVariant(d)                            {}
-        JsonValue(const char* s)                : JsonVariant(std::string(s))               {}
-        JsonValue(JsonArray&& a)                : JsonVariant(std::move(a))                 {}
-        JsonValue(JsonObject&& o)               : JsonVariant(std::move(o))                 {}
-        JsonValue(std::nullptr_t)               : JsonVariant(nullptr)                      {}
-        JsonValue(std::string&& s)              : JsonVariant(std::move(s))                 {}
-        JsonValue(const JsonArray& a)           : JsonVariant(a)                            {}
-        JsonValue(const JsonObject& o)          : JsonVariant(o)                            {}
-        JsonValue(const std::string& s)         : JsonVariant(s)                            {}
-
-
-        bool isNull()   const { return std::holds_alternative<std::nullptr_t>(JsonVariant);  }
-        bool isBool()   const { return std::holds_alternative<bool>(JsonVariant);            }
-        bool isArray()  const { return std::holds_alternative<JsonArray>(JsonVariant);       }
-        bool isNumber() const { return std::holds_alternative<double>(JsonVariant);          }
-        bool isString() const { return std::holds_alternative<std::string>(JsonVariant);     }
-        bool isObject() const { return std::holds_alternative<JsonObject>(JsonVariant);      }
-
-
-        
-        
-        bool asBool()                  const { return std::get<bool>(JsonVariant);           }
-        double asNumber()              const { return std::get<double>(JsonVariant);         }
-        const JsonArray& asArray()     const { return std::get<JsonArray>(JsonVariant);      }
-        const JsonObject& asObject()   const { return std::get<JsonObject>(JsonVariant);     }
-        const std::string& asString()  const { return std::get<std::string>(JsonVariant);    }
-
-        JsonArray& getArray() {  if (!isArray()) JsonVariant = JsonArray{};
-            return std::get<JsonArray>(JsonVariant);
+        JsonValue() noexcept                    : kind(Type::Null)                                    { data.p = nullptr; }
+        JsonValue(int i)                        : kind(Type::Int64)                                   { data.i = i; }
+        JsonValue(long i)                       : kind(Type::Int64)                                   { data.i = i; }
+        JsonValue(long long i)                  : kind(Type::Int64)                                   { data.i = i; }
+        JsonValue(unsigned u)                   : kind(Type::Int64)                                   { data.i = u; }
+        JsonValue(unsigned long u)              : JsonValue(static_cast<unsigned long long>(u))       {}
+        JsonValue(unsigned long long u);
+        JsonValue(bool b)                       : kind(Type::Bool)                                    { data.b = b; }
+        JsonValue(double d)                     : kind(Type::Double)                                  { data.d = d; }
+        JsonValue(const char* s)                : kind(Type::String)                                  { data.p = Box<std::string>::make(s); }
+        JsonValue(JsonArray&& a)                : kind(Type::Array)                                   { data.p = Box<JsonArray>::make(std::move(a)); }
+        JsonValue(JsonObject&& o)               : kind(Type::Object)                                  { data.p = Box<JsonObject>::make(std::move(o)); }
+        JsonValue(std::nullptr_t) noexcept      : JsonValue()                                         {}
+        JsonValue(std::string&& s)              : kind(Type::String)                                  { data.p = Box<std::string>::make(std::move(s)); }
+        JsonValue(const JsonArray& a)           : kind(Type::Array)                                   { data.p = Box<JsonArray>::make(a); }
+        JsonValue(const JsonObject& o)          : kind(Type::Object)                                  { data.p = Box<JsonObject>::make(o); }
+        JsonValue(const std::string& s)         : kind(Type::String)                                  { data.p = Box<std::string>::make(s); }
+
+        JsonValue(const JsonValue& other);
+        JsonValue(JsonValue&& other) noexcept   : data(other.data), kind(other.kind)                  { other.kind = Type::Null; }
+        ~JsonValue()                                                                                  { if (kind >= Type::String) destroy(); }
+
+        // Through a temporary, so assigning a value its own child is safe.
+        JsonValue& operator=(const JsonValue& other)        { JsonValue t(other);            swap(t); return *this; }
+        JsonValue& operator=(JsonValue&& other) noexcept    { JsonValue t(std::move(other)); swap(t); return *this; }
+
+        void swap(JsonValue& other) noexcept {
+            Data d = data;  data = other.data;  other.data = d;
+            Type k = kind;  kind = other.kind;  other.kind = k;
+        }
+        friend void swap(JsonValue& a, JsonValue& b) noexcept { a.swap(b); }
+
+        Type type()      const { return kind; }
+
+        bool isNull()    const { return kind == Type::Null;    }
+        bool isBool()    const { return kind == Type::Bool;    }
+        bool isArray()   const { return kind == Type::Array;   }
+        bool isNumber()  const { return kind == Type::Double || isInteger(); }
+        bool isString()  const { return kind == Type::String;  }
+        bool isObject()  const { return kind == Type::Object;  }
+        bool isInteger() const { return kind == Type::Int64 || kind == Type::UInt64; }
+
+        // Like std::get_if: the stored bool, double, int64_t, uint64_t, std::string, JsonObject or
+        // JsonArray, nullptr when the value holds something else.
+        template<typename T>
+        const T* getIf() const {
+            if (kind != typeOf<T>()) return nullptr;
+            if constexpr (std::is_same<T, bool>::value)          return &data.b;
+            else if constexpr (std::is_same<T, double>::value)   return &data.d;
+            else if constexpr (std::is_same<T, int64_t>::value)  return &data.i;
+            else if constexpr (std::is_same<T, uint64_t>::value) return &data.u;
+            else return &static_cast<Box<T>*>(data.p)->value;
+        }
+
+        template<typename T>
+        T* getIf() { return const_cast<T*>(static_cast<const JsonValue&>(*this).getIf<T>()); }
+
+        // The std::variant a JsonValue used to be, from when the node exposed it as the JsonVariant
+        // member. JsonVariant() hands out a copy of the whole subtree in that shape, so existing
+        // std::get/std::visit code keeps compiling with "()" added, but writes to it do not reach
+        // the node. Use type() and getIf<T>() instead, they read in place.
+        using Variant = std::variant<std::nullptr_t, bool, double, int64_t, uint64_t, std::string, JsonObject, JsonArray>;
+        [[deprecated("JsonValue no longer stores a std::variant, use type() and getIf<T>()")]]
+        Variant JsonVariant() const;
+
+        bool asBool()                  const { return get<bool>();                            }
+        double asNumber()              const {
+            if (kind == Type::Int64)  return static_cast<double>(data.i);
+            if (kind == Type::UInt64) return static_cast<double>(data.u);
+            return get<double>();
+        }
+
+        // Integers are stored exactly; a double is truncated towards zero and saturates at the
+        // limits of the result type, NaN reads as 0.
+        int64_t asInt64()              const {
+            if (kind == Type::Int64)  return data.i;
+            if (kind == Type::UInt64) return static_cast<int64_t>(data.u);
+            double d = get<double>();
+            if (d != d)                         return 0;
+            if (d >= 9223372036854775808.0)     return INT64_MAX;       // 2^63
+            if (d <= -9223372036854775808.0)    return INT64_MIN;
+            return static_cast<int64_t>(d);
+        }
+
+        uint64_t asUInt64()            const {
+            if (kind == Type::UInt64) return data.u;
+            if (kind == Type::Int64)  return static_cast<uint64_t>(data.i);
+            double d = get<double>();
+            if (!(d > 0.0))                     return 0;               // negative or NaN
+            if (d >= 18446744073709551616.0)    return UINT64_MAX;      // 2^64
+            return static_cast<uint64_t>(d);
+        }
+
+        const JsonArray& asArray()     const { return get<JsonArray>();                       }
+        const JsonObject& asObject()   const { return get<JsonObject>();                      }
+        const std::string& asString()  const { return get<std::string>();                     }
+
+        JsonArray& getArray() {  if (!isArray()) *this = JsonValue(JsonArray{});
+            return *getIf<JsonArray>();
         }
 
         JsonObject& getObject() {
-            if (!isObject()) JsonVariant = JsonObject{};
-            return std::get<JsonObject>(JsonVariant);
+            if (!isObject()) *this = JsonValue(JsonObject{});
+            return *getIf<JsonObject>();
         }
 
         JsonValue& operator[](const std::string& key) {
-            return getObject()[key];
+            #ifdef HMS_JSON_INTERN_KEYS
+                // Only a missing member costs a key.
+                auto& o = getObject();
+                auto it = o.find(std::string_view(key));
+                if (it != o.end()) return it->second;
+                return o.emplace(key, JsonValue{}).first->second;
+            #else
+                return getObject()[key];
+            #endif
         }
         JsonValue& operator[](std::size_t idx) {
             auto &a = getArray();
@@ -68,7 +153,119 @@ namespace HMS {
             return a[idx];
         }
 
+        private:
+            /*
+             * Out of line storage for strings and containers. It remembers the arena it came from,
+             * heap boxes are freed with the node while arena boxes go away with the arena.
+             */
+            template<typename T>
+            struct Box {
+                JsonArena*  arena;
+                T           value;
+
+                template<typename... Args>
+                Box(JsonArena* a, Args&&... args) : arena(a), value(std::forward<Args>(args)...) {}
+
+                template<typename... Args>
+                static Box* make(Args&&... args) {
+                    JsonArena* a = JsonArena::current();
+                    Box* b = new (a) Box(a, std::forward<Args>(args)...);
+                    #ifdef HMS_JSON_STATS
+                        HMS_JSON_STATS_ADD(allocations, 1);
+                        HMS_JSON_STATS_ADD(allocatedBytes, sizeof(Box));
+                        if constexpr (std::is_same<T, std::string>::value) {
+                            if (b->value.capacity() > std::string().capacity()) {
+                                HMS_JSON_STATS_ADD(allocations, 1);
+                                HMS_JSON_STATS_ADD(allocatedBytes, b->value.capacity() + 1);
+                            }
+                        }
+                    #endif
+                    return b;
+                }
+
+                static void* operator new(size_t n, JsonArena* a) { return a ? a->allocate(n, alignof(Box)) : ::operator new(n); }
+                static void operator delete(void* p, JsonArena* a) noexcept { if (!a) ::operator delete(p); }  // a throwing constructor
+
+                static void free(void* p) noexcept {
+                    Box* b = static_cast<Box*>(p);
+                    JsonArena* a = b->arena;
+                    b->~Box();
+                    if (!a) ::operator delete(b);
+                }
+            };
+
+            union Data {
+                bool        b;
+                double      d;
+                int64_t     i;
+                uint64_t    u;
+                void*       p;      // Box<std::string>, Box<JsonObject> or Box<JsonArray>
+            };
+
+            Data    data;
+            Type    kind;
+
+            template<typename T>
+            static constexpr Type typeOf() {
+                if constexpr (std::is_same<T, bool>::value)             return Type::Bool;
+                else if constexpr (std::is_same<T, double>::value)      return Type::Double;
+                else if constexpr (std::is_same<T, int64_t>::value)     return Type::Int64;
+                else if constexpr (std::is_same<T, uint64_t>::value)    return Type::UInt64;
+                else if constexpr (std::is_same<T, std::string>::value) return Type::String;
+                else if constexpr (std::is_same<T, JsonObject>::value)  return Type::Object;
+                else {
+                    static_assert(std::is_same<T, JsonArray>::value, "not a JsonValue alternative");
+                    return Type::Array;
+                }
+            }
+
+            // Reading the wrong type fails the way std::get on the former std::variant did.
+            template<typename T>
+            const T& get() const {
+                if (const T* p = getIf<T>()) return *p;
+                #if HMS_JSON_EXCEPTIONS_ENABLED
+                    throw std::bad_variant_access();
+                #else
+                    std::abort();
+                #endif
+            }
+
+            void destroy() noexcept {
+                if (kind == Type::String)       Box<std::string>::free(data.p);
+                else if (kind == Type::Object)  Box<JsonObject>::free(data.p);
+                else                            Box<JsonArray>::free(data.p);
+            }
     };
+
+    // Unsigned values only use the uint64_t alternative when they do not fit in int64_t.
+    inline JsonValue::JsonValue(unsigned long long u) {
+        if (u <= static_cast<unsigned long long>(INT64_MAX)) { kind = Type::Int64;  data.i = static_cast<int64_t>(u); }
+        else                                                 { kind = Type::UInt64; data.u = static_cast<uint64_t>(u); }
+    }
+
+    inline JsonValue::JsonValue(const JsonValue& other) : kind(other.kind) {
+        switch (kind) {
+            case Type::String:  data.p = Box<std::string>::make(*other.getIf<std::string>());   break;
+            case Type::Object:  data.p = Box<JsonObject>::make(*other.getIf<JsonObject>());     break;
+            case Type::Array:   data.p = Box<JsonArray>::make(*other.getIf<JsonArray>());       break;
+            default:            data = other.data;                                              break;
+        }
+    }
+
+    inline JsonValue::Variant JsonValue::JsonVariant() const {
+        switch (kind) {
+            case Type::Bool:    return data.b;
+            case Type::Double:  return data.d;
+            case Type::Int64:   return data.i;
+            case Type::UInt64:  return data.u;
+            case Type::String:  return *getIf<std::string>();
+            case Type::Object:  return *getIf<JsonObject>();
+            case Type::Array:   return *getIf<JsonArray>();
+            default:            return nullptr;
+        }
+    }
+
+    static_assert(sizeof(JsonValue) <= 16, "JsonValue should stay a 16 byte node");
 }
 
 #endif // HMS_JSON_VALUE_H
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef HMS_JSON_WRITER_H
+#define HMS_JSON_WRITER_H
+
+#include "HMS_JSON_Value.h"
+#include "HMS_JSON_Sink.h"
+
+namespace HMS {
+    /*
+     * Writes JSON straight to a sink without building a JsonValue, producing the same bytes as
+     * JsonSerializer would for the equivalent tree, compact or pretty:
+     *
+     *      JsonStringSink sink(payload);
+     *      JsonWriter w(sink);
+     *      w.beginObject().member("id", 7).key("temps").beginArray().value(21.5).value(22.0).endArray().endObject();
+     *
+     * Output is buffered and handed to the sink in chunks, flush() or the destructor pushes out the
+     * rest. The calls have to describe a well formed document, they are not checked.
+     */
+    class JsonWriter {
+        public:
+            explicit JsonWriter(JsonSink& sink, bool pretty=false, int indent=2) : out(sink), pretty(pretty), indent(indent) {}
+
+            JsonWriter(const JsonWriter&)               = delete;
+            JsonWriter& operator=(const JsonWriter&)    = delete;
+
+            JsonWriter& beginObject();
+            JsonWriter& endObject();
+            JsonWriter& beginArray();
+            JsonWriter& endArray();
+            JsonWriter& key(std::string_view k);
+
+            JsonWriter& value(std::nullptr_t);
+            JsonWriter& value(bool b);
+            JsonWriter& value(double d);
+            JsonWriter& value(int i)                        { return value(static_cast<long long>(i)); }
+            JsonWriter& value(long i)                       { return value(static_cast<long long>(i)); }
+            JsonWriter& value(long long i);
+            JsonWriter& value(unsigned u)                   { return value(static_cast<unsigned long long>(u)); }
+            JsonWriter& value(unsigned long u)              { return value(static_cast<unsigned long long>(u)); }
+            JsonWriter& value(unsigned long long u);
+            JsonWriter& value(const char* s)                { return value(std::string_view(s)); }
+            JsonWriter& value(const std::string& s)         { return value(std::string_view(s)); }
+            JsonWriter& value(std::string_view s);
+            JsonWriter& value(const JsonValue& v);          // a prepared subtree
+
+            template<typename T>
+            JsonWriter& member(std::string_view k, T&& v)   { key(k); return value(std::forward<T>(v)); }
+
+            // Open containers; 0 once the document is complete.
+            size_t depth() const                            { return stack.size(); }
+            void flush()                                    { out.flush(); }
+
+        private:
+            JsonOutput          out;
+            bool                pretty;
+            int                 indent;
+            bool                first       = true;         // nothing written yet in the innermost container
+            bool                afterKey    = false;
+            std::vector<char>   stack;                      // closing bracket per open container
+
+            void separate();
+            JsonWriter& open(char bracket, char closing);
+            JsonWriter& close();
+    };
+}
+
+#endif // HMS_JSON_WRITER_H
@@ -0,0 +1,48 @@
+#include "HMS_JSON_Arena.h"
+
+namespace HMS {
+    JsonArena::JsonArena(size_t chunkSize) 
+        : chunkSize(chunkSize ? chunkSize : DEFAULT_CHUNK_SIZE), nextChunk(this->chunkSize) {}
+
+    JsonArena::JsonArena(void* buffer, size_t size, size_t chunkSize)
+        : JsonArena(chunkSize) {
+        this->buffer        = buffer;
+        this->bufferSize    = size;
+        cursor              = static_cast<unsigned char*>(buffer);
+        limit               = cursor ? cursor + size : nullptr;
+    }
+
+    JsonArena::~JsonArena() {
+        release();
+    }
+
+    void JsonArena::release() {
+        while (chunks) {
+            Chunk* next = chunks->next;
+            ::operator delete(chunks);
+            chunks = next;
+        }
+        cursor      = static_cast<unsigned char*>(buffer);
+        limit       = cursor ? cursor + bufferSize : nullptr;
+        nextChunk   = chunkSize;
+        used        = 0;
+        heap        = 0;
+    }
+
+    void* JsonArena::allocateSlow(size_t bytes, size_t align) {
+        size_t header   = (sizeof(Chunk) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        size_t need     = header + bytes + align;
+        size_t size     = need > nextChunk ? need : nextChunk;
+
+        Chunk* chunk    = static_cast<Chunk*>(::operator new(size));
+        chunk->next     = chunks;
+        chunk->size     = size;
+        chunks          = chunk;
+        heap           += size;
+        if (nextChunk < MAX_CHUNK_SIZE) nextChunk *= 2;
+
+        cursor          = reinterpret_cast<unsigned char*>(chunk) + header;
+        limit           = reinterpret_cast<unsigned char*>(chunk) + size;
+        return allocate(bytes, align);
+    }
+}
@@ -0,0 +1,194 @@
+#include "HMS_JSON_Bind.h"
+
+#include <cmath>
+
+namespace HMS {
+    namespace {
+        inline bool isNumberStart(char c) { return c == '-' || (c >= '0' && c <= '9'); }
+
+        // Integer fields also take doubles with an integral value (-0, 1.0, 1e3); fractions fail.
+        inline bool integralDouble(const JsonValue& v, double& d) {
+            const double* p = v.getIf<double>();
+            if (!p || std::trunc(*p) != *p) return false;
+            d = *p;
+            return true;
+        }
+    }
+
+    #if HMS_JSON_EXCEPTIONS_ENABLED
+        JsonReader::JsonReader(std::string_view src) : deser(src) {
+            deser.prepare(tokens);
+            deser.nextToken();
+        }
+    #else
+        JsonReader::JsonReader(std::string_view src, ParseError& err_out) : deser(src) {
+            err_out     = ParseError{};
+            deser.err   = &err_out;
+            deser.prepare(tokens);
+            deser.nextToken();
+        }
+    #endif
+
+    // Like the tree parser, a value that is missing altogether is reported as the end of input.
+    bool JsonReader::expect(bool ok, const char* msg) {
+        valueAt = deser.pos;
+        if (ok) return true;
+        if (deser.pos >= deser.string.size()) return deser.error("Unexpected end of input");
+        return deser.error(msg);
+    }
+
+    bool JsonReader::fail(const char* msg) {
+        return deser.error(msg, valueAt);
+    }
+
+    bool JsonReader::beginObject() {
+        if (!expect(peek() == '{', "Expected object")) return false;
+        deser.pos++;
+        deser.nextToken();
+        first = true;
+        return true;
+    }
+
+    bool JsonReader::nextMember(std::string_view& key, bool& end) {
+        char c = peek();
+        end = c == '}';
+        if (end) {
+            deser.pos++;
+            deser.nextToken();
+            first = false;
+            return true;
+        }
+        if (!first) {
+            if (c != ',') return deser.error("Expected ',' or '}' in object");
+            deser.pos++;
+            c = deser.nextToken();
+        }
+        first = false;
+        if (c != '"') return deser.error("Object keys must be strings");
+        if (!deser.saxString(key)) return false;
+        if (deser.nextToken() != ':') return deser.error("Expected ':'");
+        deser.pos++;
+        deser.nextToken();
+        return true;
+    }
+
+    bool JsonReader::beginArray() {
+        if (!expect(peek() == '[', "Expected array")) return false;
+        deser.pos++;
+        deser.nextToken();
+        first = true;
+        return true;
+    }
+
+    bool JsonReader::nextElement(bool& end) {
+        char c = peek();
+        end = c == ']';
+        if (end) {
+            deser.pos++;
+            deser.nextToken();
+            first = false;
+            return true;
+        }
+        if (!first) {
+            if (c != ',') return deser.error("Expected ',' or ']' in array");
+            deser.pos++;
+            deser.nextToken();
+        }
+        first = false;
+        return true;
+    }
+
+    bool JsonReader::readNull(bool& wasNull) {
+        wasNull = peek() == 'n';
+        if (!wasNull) return true;
+        JsonValue v;
+        valueAt = deser.pos;
+        if (!deser.parseNull(v)) return false;
+        deser.nextToken();
+        return true;
+    }
+
+    bool JsonReader::read(bool& out) {
+        char c = peek();
+        if (!expect(c == 't' || c == 'f', "Expected boolean")) return false;
+        JsonValue v;
+        if (!deser.parseBool(v)) return false;
+        deser.nextToken();
+        out = v.asBool();
+        return true;
+    }
+
+    // Scalars go through a temporary JsonValue, which never allocates for numbers.
+    bool JsonReader::read(double& out) {
+        if (!expect(isNumberStart(peek()), "Expected number")) return false;
+        JsonValue v;
+        if (!deser.parseNumber(v)) return false;
+        deser.nextToken();
+        out = v.asNumber();
+        return true;
+    }
+
+    bool JsonReader::read(int64_t& out) {
+        if (!expect(isNumberStart(peek()), "Expected number")) return false;
+        JsonValue v;
+        if (!deser.parseNumber(v)) return false;
+        deser.nextToken();
+        if (auto i = v.getIf<int64_t>()) { out = *i; return true; }
+        double d;
+        if (integralDouble(v, d)) {
+            if (d < -9223372036854775808.0 || d >= 9223372036854775808.0) return fail("Number out of range");
+            out = static_cast<int64_t>(d);
+            return true;
+        }
+        return fail(v.isInteger() ? "Number out of range" : "Expected integer");
+    }
+
+    bool JsonReader::read(uint64_t& out) {
+        if (!expect(isNumberStart(peek()), "Expected number")) return false;
+        JsonValue v;
+        if (!deser.parseNumber(v)) return false;
+        deser.nextToken();
+        if (auto u = v.getIf<uint64_t>()) { out = *u; return true; }
+        if (auto i = v.getIf<int64_t>()) {
+            if (*i < 0) return fail("Number out of range");
+            out = static_cast<uint64_t>(*i);
+            return true;
+        }
+        double d;
+        if (integralDouble(v, d)) {
+            if (d < 0.0 || d >= 18446744073709551616.0) return fail("Number out of range");
+            out = static_cast<uint64_t>(d);
+            return true;
+        }
+        return fail("Expected integer");
+    }
+
+    bool JsonReader::read(std::string& out) {
+        if (!expect(peek() == '"', "Expected string")) return false;
+        std::string_view s;
+        if (!deser.saxString(s)) return false;
+        deser.nextToken();
+        out.assign(s.data(), s.size());
+        return true;
+    }
+
+    bool JsonReader::read(JsonValue& out) {
+        valueAt = deser.pos;
+        if (!deser.parseJsonValue(out)) return false;
+        deser.nextToken();
+        return true;
+    }
+
+    bool JsonReader::skip() {
+        JsonSaxHandler ignore;                  // accepts every event, the value is only checked
+        valueAt = deser.pos;
+        if (!deser.saxValue(ignore)) return false;
+        deser.nextToken();
+        return true;
+    }
+
+    bool JsonReader::finish() {
+        if (deser.pos != deser.string.size()) return deser.error("Trailing data after JSON");
+        return true;
+    }
+}
@@ -0,0 +1,346 @@
+#include "HMS_JSON_Cbor.h"
+#include "HMS_JSON_Strings.h"
+#include "HMS_JSON_Unicode.h"
+
+#include <cmath>
+
+namespace HMS {
+    namespace {
+        enum Major : uint8_t { Unsigned, Negative, Bytes, Text, Array, Map, Tag, Simple };
+
+        constexpr uint8_t INDEFINITE    = 31;
+        constexpr uint8_t BREAK         = 0xFF;
+
+        double halfToDouble(uint16_t h) {
+            int exp     = (h >> 10) & 0x1F;
+            int mant    = h & 0x3FF;
+            double d;
+            if (exp == 0)       d = std::ldexp(mant, -24);
+            else if (exp == 31) d = mant ? NAN : INFINITY;
+            else                d = std::ldexp(mant + 1024, exp - 25);
+            return (h & 0x8000) ? -d : d;
+        }
+
+        // Half precision bits of d when it converts without loss.
+        bool doubleToHalf(double d, uint16_t& h) {
+            uint16_t sign   = std::signbit(d) ? 0x8000 : 0;
+            double a        = std::fabs(d);
+            if (std::isinf(a))  { h = sign | 0x7C00; return true; }
+            if (a == 0)         { h = sign; return true; }
+            int e;
+            double m = std::frexp(a, &e);                               // a = m * 2^e, m in [0.5, 1)
+            double bits;
+            if (e + 14 >= 1) {
+                if (e + 14 > 30) return false;
+                bits = std::ldexp(2 * m - 1, 10);
+                if (bits != std::floor(bits)) return false;
+                h = static_cast<uint16_t>(sign | ((e + 14) << 10) | static_cast<uint16_t>(bits));
+            } else {
+                bits = std::ldexp(a, 24);                               // subnormal, multiples of 2^-24
+                if (bits != std::floor(bits) || bits >= 1024) return false;
+                h = static_cast<uint16_t>(sign | static_cast<uint16_t>(bits));
+            }
+            return true;
+        }
+
+        void writeHead(JsonOutput& out, uint8_t major, uint64_t n) {
+            char* p = out.reserve(9);
+            uint8_t ib = static_cast<uint8_t>(major << 5);
+            int bytes;
+            if (n < 24)                 { p[0] = static_cast<char>(ib | n); out.commit(1); return; }
+            else if (n <= 0xFF)         { ib |= 24; bytes = 1; }
+            else if (n <= 0xFFFF)       { ib |= 25; bytes = 2; }
+            else if (n <= 0xFFFFFFFF)   { ib |= 26; bytes = 4; }
+            else                        { ib |= 27; bytes = 8; }
+            p[0] = static_cast<char>(ib);
+            for (int i = 0; i < bytes; ++i) p[1 + i] = static_cast<char>(n >> (8 * (bytes - 1 - i)));
+            out.commit(static_cast<size_t>(bytes) + 1);
+        }
+
+        void writeFloat(JsonOutput& out, double d) {
+            char* p = out.reserve(9);
+            uint16_t h;
+            if (std::isnan(d)) {
+                h = 0x7E00;
+            } else if (!doubleToHalf(d, h)) {
+                float f = static_cast<float>(d);
+                if (static_cast<double>(f) == d) {
+                    uint32_t bits;
+                    std::memcpy(&bits, &f, sizeof bits);
+                    p[0] = static_cast<char>(0xFA);
+                    for (int i = 0; i < 4; ++i) p[1 + i] = static_cast<char>(bits >> (24 - 8 * i));
+                    out.commit(5);
+                } else {
+                    uint64_t bits;
+                    std::memcpy(&bits, &d, sizeof bits);
+                    p[0] = static_cast<char>(0xFB);
+                    for (int i = 0; i < 8; ++i) p[1 + i] = static_cast<char>(bits >> (56 - 8 * i));
+                    out.commit(9);
+                }
+                return;
+            }
+            p[0] = static_cast<char>(0xF9);
+            p[1] = static_cast<char>(h >> 8);
+            p[2] = static_cast<char>(h);
+            out.commit(3);
+        }
+
+        void writeText(JsonOutput& out, std::string_view s) {
+            writeHead(out, Text, s.size());
+            out.write(s.data(), s.size());
+        }
+
+        void encodeValue(JsonOutput& out, const JsonValue& v) {
+            switch (v.type()) {
+                case JsonValue::Type::Int64: {
+                    int64_t i = v.asInt64();
+                    if (i >= 0) writeHead(out, Unsigned, static_cast<uint64_t>(i));
+                    else writeHead(out, Negative, static_cast<uint64_t>(-1 - i));
+                    break;
+                }
+                case JsonValue::Type::UInt64:   writeHead(out, Unsigned, v.asUInt64());                     break;
+                case JsonValue::Type::Double:   writeFloat(out, v.asNumber());                              break;
+                case JsonValue::Type::String:   writeText(out, v.asString());                               break;
+                case JsonValue::Type::Bool:     out.put(static_cast<char>(v.asBool() ? 0xF5 : 0xF4));       break;
+                case JsonValue::Type::Array:
+                    writeHead(out, Array, v.asArray().size());
+                    for (const JsonValue& e : v.asArray()) encodeValue(out, e);
+                    break;
+                case JsonValue::Type::Object:
+                    writeHead(out, Map, v.asObject().size());
+                    for (const auto& kv : v.asObject()) {
+                        writeText(out, kv.first);
+                        encodeValue(out, kv.second);
+                    }
+                    break;
+                case JsonValue::Type::Null:     out.put(static_cast<char>(0xF6));                           break;
+            }
+        }
+
+        // Offset of the first byte that is not well formed UTF-8, or end.
+        const uint8_t* findBadUtf8(const uint8_t* p, const uint8_t* end) {
+            while (p < end) {
+                p = reinterpret_cast<const uint8_t*>(detail::scanStringLiteral(reinterpret_cast<const char*>(p), reinterpret_cast<const char*>(end), true));
+                if (p >= end) break;
+                if (*p < 0x80) { p++; continue; }                          // quote or backslash, plain bytes here
+                size_t len = detail::utf8SequenceLength(p, end);
+                if (!len) return p;
+                p += len;
+            }
+            return end;
+        }
+
+        class CborDecoder {
+            public:
+                CborDecoder(const uint8_t* data, size_t len, ParseError* err) : begin(data), p(data), end(data + len), err(err) {}
+
+                bool document(JsonValue& out) {
+                    #ifdef HMS_JSON_INTERN_KEYS
+                        detail::ParseKeyScope keys;
+                    #endif
+                    if (!value(out)) return false;
+                    if (p != end) return fail("Trailing data after CBOR", p);
+                    return true;
+                }
+
+            private:
+                const uint8_t*  begin;
+                const uint8_t*  p;
+                const uint8_t*  end;
+                ParseError*     err;
+                unsigned        depth   = 0;        // open arrays and maps
+
+                bool fail(const char* msg, const uint8_t* at) {
+                    ErrorPos pos{1, static_cast<int>(at - begin) + 1};
+                    #if HMS_JSON_EXCEPTIONS_ENABLED
+                        (void)err;
+                        throw ParseError(msg, pos);
+                    #else
+                        *err = ParseError(msg, pos);
+                        return false;
+                    #endif
+                }
+
+                size_t left() const { return static_cast<size_t>(end - p); }
+
+                // Initial byte and argument of the next item; info is INDEFINITE without an argument.
+                bool head(uint8_t& major, uint8_t& info, uint64_t& n) {
+                    if (p >= end) return fail("Unexpected end of input", p);
+                    const uint8_t* at = p;
+                    major   = *p >> 5;
+                    info    = *p & 0x1F;
+                    p++;
+                    n       = info;
+                    if (info < 24) return true;
+                    if (info == INDEFINITE) {
+                        if (major == Bytes || major == Text || major == Array || major == Map) return true;
+                        return fail(major == Simple ? "Unexpected break" : "Invalid CBOR item", at);
+                    }
+                    if (info > 27) return fail("Invalid CBOR item", at);
+                    size_t bytes = size_t(1) << (info - 24);
+                    if (left() < bytes) return fail("Unexpected end of input", end);
+                    n = 0;
+                    for (size_t i = 0; i < bytes; ++i) n = (n << 8) | *p++;
+                    return true;
+                }
+
+                bool atBreak() {
+                    if (p < end && *p == BREAK) { p++; return true; }
+                    return false;
+                }
+
+                bool text(std::string& out, uint8_t info, uint64_t n) {
+                    if (info != INDEFINITE) return chunk(out, n);
+                    while (!atBreak()) {
+                        const uint8_t* at = p;
+                        uint8_t major = 0, inner = 0;
+                        if (!head(major, inner, n)) return false;
+                        if (major != Text || inner == INDEFINITE) return fail("Invalid CBOR item", at);
+                        if (!chunk(out, n)) return false;
+                    }
+                    return true;
+                }
+
+                bool chunk(std::string& out, uint64_t n) {
+                    if (n > left()) return fail("Unexpected end of input", end);
+                    const uint8_t* last = p + n;
+                    const uint8_t* bad  = findBadUtf8(p, last);
+                    if (bad != last) return fail("Invalid UTF-8", bad);
+                    out.append(reinterpret_cast<const char*>(p), static_cast<size_t>(n));
+                    p = last;
+                    return true;
+                }
+
+                // Input is untrusted, so nesting is bounded before it can exhaust the stack.
+                bool enter(const uint8_t* at) {
+                    if (++depth > HMS_JSON_CBOR_MAX_DEPTH) return fail("Nesting too deep", at);
+                    return true;
+                }
+
+                bool array(JsonValue& out, uint8_t info, uint64_t n) {
+                    JsonArray arr;
+                    if (info == INDEFINITE) {
+                        while (!atBreak()) {
+                            arr.emplace_back();
+                            if (!value(arr.back())) return false;
+                        }
+                    } else {
+                        arr.reserve(n < left() ? static_cast<size_t>(n) : left());     // every item takes a byte at least
+                        for (uint64_t i = 0; i < n; ++i) {
+                            arr.emplace_back();
+                            if (!value(arr.back())) return false;
+                        }
+                    }
+                    out = JsonValue(std::move(arr));
+                    depth--;
+                    return true;
+                }
+
+                // The first of duplicate keys wins, as with JsonDeserializer.
+                bool map(JsonValue& out, uint8_t info, uint64_t n) {
+                    JsonObject obj;
+                    for (uint64_t i = 0; info == INDEFINITE || i < n; ++i) {
+                        if (info == INDEFINITE && atBreak()) break;
+                        const uint8_t* at = p;
+                        uint8_t major = 0, keyInfo = 0;
+                        uint64_t len = 0;
+                        if (!head(major, keyInfo, len)) return false;
+                        if (major != Text) return fail("Object keys must be strings", at);
+                        std::string key;
+                        if (!text(key, keyInfo, len)) return false;
+                        JsonValue val;
+                        if (!value(val)) return false;
+                        obj.emplace(std::move(key), std::move(val));
+                    }
+                    out = JsonValue(std::move(obj));
+                    depth--;
+                    return true;
+                }
+
+                bool simple(JsonValue& out, uint8_t info, uint64_t n, const uint8_t* at) {
+                    switch (info) {
+                        case 20: out = JsonValue(false);    return true;
+                        case 21: out = JsonValue(true);     return true;
+                        case 22:
+                        case 23: out = JsonValue(nullptr);  return true;
+                        case 25: out = JsonValue(halfToDouble(static_cast<uint16_t>(n))); return true;
+                        case 26: {
+                            uint32_t bits = static_cast<uint32_t>(n);
+                            float f;
+                            std::memcpy(&f, &bits, sizeof f);
+                            out = JsonValue(static_cast<double>(f));
+                            return true;
+                        }
+                        case 27: {
+                            double d;
+                            std::memcpy(&d, &n, sizeof d);
+                            out = JsonValue(d);
+                            return true;
+                        }
+                        default:
+                            return fail("Unsupported simple value", at);
+                    }
+                }
+
+                bool value(JsonValue& out) {
+                    const uint8_t* at = p;
+                    uint8_t major = 0, info = 0;
+                    uint64_t n = 0;
+                    do {                                                        // JSON has no use for tags, they are skipped
+                        at = p;
+                        if (!head(major, info, n)) return false;
+                    } while (major == Tag);
+                    switch (major) {
+                        case Unsigned:
+                            out = JsonValue(static_cast<unsigned long long>(n));
+                            return true;
+                        case Negative:
+                            if (n <= static_cast<uint64_t>(INT64_MAX)) out = JsonValue(static_cast<long long>(-1 - static_cast<int64_t>(n)));
+                            else out = JsonValue(-1.0 - static_cast<double>(n));
+                            return true;
+                        case Bytes:
+                            return fail("Byte strings are not supported", at);
+                        case Text: {
+                            std::string s;
+                            if (!text(s, info, n)) return false;
+                            out = JsonValue(std::move(s));
+                            return true;
+                        }
+                        case Array:
+                            return enter(at) && array(out, info, n);
+                        case Map:
+                            return enter(at) && map(out, info, n);
+                        default:
+                            return simple(out, info, n, at);
+                    }
+                }
+        };
+    }
+
+    void JsonCbor::encode(const JsonValue& v, JsonSink& sink) {
+        JsonOutput out(sink);
+        encodeValue(out, v);
+    }
+
+    std::vector<uint8_t> JsonCbor::encode(const JsonValue& v) {
+        std::vector<uint8_t> bytes;
+        auto sink = makeSink([&](const char* data, size_t len) { bytes.insert(bytes.end(), data, data + len); });
+        encode(v, sink);
+        return bytes;
+    }
+
+    #if HMS_JSON_EXCEPTIONS_ENABLED
+        JsonValue JsonCbor::decode(const uint8_t* data, size_t len) {
+            JsonValue v;
+            CborDecoder(data, len, nullptr).document(v);
+            return v;
+        }
+    #else
+        JsonValue JsonCbor::decode(const uint8_t* data, size_t len, ParseError& err_out) {
+            err_out = ParseError{};
+            JsonValue v;
+            if (!CborDecoder(data, len, &err_out).document(v)) return JsonValue{};
+            return v;
+        }
+    #endif
+}
@@ -1,384 +1,430 @@
 #include "HMS_JSON_Deserializer.h"
+#include "HMS_JSON_Number.h"
+#include "HMS_JSON_Recorder.h"
+#include "HMS_JSON_Skip.h"
+#include "HMS_JSON_Strings.h"
+#include "HMS_JSON_Structural.h"
+#include "HMS_JSON_Unicode.h"
+
+#include <cstring>
 
 namespace HMS {
+    namespace {
+        inline bool isDigit(char c)     { return c >= '0' && c <= '9'; }
+
+        // isDelimiter(): characters that may legally follow a number or literal; anything else glued
+        // to a scalar is not a token start in the structural index and has to be rejected here.
+        using detail::isJsonSpace;
+        using detail::isDelimiter;
+    }
+
     #if HMS_JSON_EXCEPTIONS_ENABLED
-        JsonValue JsonDeserializer::deserialize(const std::string& src) {
+        JsonValue JsonDeserializer::deserialize(std::string_view src) {
             JsonDeserializer deser{src};
-            return deser.deserializeInternal();
+            JsonValue v;
+            deser.deserializeInternal(v);
+            return v;
         }
 
-        [[noreturn]] void JsonDeserializer::error(const std::string& msg) {
-            throw ParseError(msg, posinfo);
+        JsonValue JsonDeserializer::deserialize(const char* data, size_t len) {
+            return deserialize(std::string_view(data, len));
         }
 
-        JsonValue JsonDeserializer::deserializeInternal() {
-            skipWhitespace();
-            JsonValue v = parseJsonValue();
-            skipWhitespace();
-            if (pos != string.size()) error("Trailing data after JSON");
-            return v;
+        void JsonDeserializer::parse(std::string_view src, JsonSaxHandler& handler) {
+            JsonDeserializer deser{src};
+            deser.saxInternal(handler);
         }
 
-        JsonValue JsonDeserializer::parseJsonValue() {
-            if (pos >= string.size()) error("Unexpected end of input");
-            char c = string[pos];
-            if (c == 'n') return parseNull();
-            if (c == 't' || c == 'f') return parseBool();
-            if (c == '"') return parseString();
-            if (c == '[') return parseArray();
-            if (c == '{') return parseObject();
-            if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) return parseNumber();
-            error(std::string("Unexpected character '") + c + "'");
-            return JsonValue{};
+        bool JsonDeserializer::error(const std::string& msg, size_t at) {
+            throw ParseError(msg, locate(string, at));
+        }
+    #else
+        JsonValue JsonDeserializer::deserialize(std::string_view src, ParseError& err_out) {
+            err_out = ParseError{};
+            JsonDeserializer deser{src};
+            deser.err = &err_out;
+            JsonValue v;
+            if (!deser.deserializeInternal(v)) return JsonValue{};
+            return v;
         }
 
-        JsonValue JsonDeserializer::parseNumber() {
-            size_t start = pos;
-            if (string[pos] == '-') advance();
-                while (pos < string.size() && std::isdigit(static_cast<unsigned char>(string[pos]))) advance();
-                if (pos < string.size() && string[pos] == '.') {
-                    advance();
-                    while (pos < string.size() && std::isdigit(static_cast<unsigned char>(string[pos]))) advance();
-                }
-                if (pos < string.size() && (string[pos] == 'e' || string[pos] == 'E')) {
-                    advance();
-                    if (string[pos] == '+' || string[pos] == '-') advance();
-                while (pos < string.size() && std::isdigit(static_cast<unsigned char>(string[pos]))) advance();
-            }
-            std::string tok = string.substr(start, pos - start);
-            try {
-                double d = std::stod(tok);
-                return JsonValue(d);
-            } catch (...) {
-                error("Invalid number format");
-                return JsonValue{};
-            }
+        JsonValue JsonDeserializer::deserialize(const char* data, size_t len, ParseError& err_out) {
+            return deserialize(std::string_view(data, len), err_out);
         }
 
-        JsonValue JsonDeserializer::parseString() {
-            expectChar('"');
-            std::string out;
-            bool found_closing_quote = false;
-            while (pos < string.size()) {
-                char c = string[pos++];
-                if (c == '"') { posinfo.col++; found_closing_quote = true; break; }
-                if (c == '\\') {
-                    if (pos >= string.size()) error("Invalid escape");
-                    char e = string[pos++];
-                    posinfo.col++;
-                    switch (e) {
-                        case '"':   out.push_back('"');     break;
-                        case '\\':  out.push_back('\\');    break;
-                        case '/':   out.push_back('/');     break;
-                        case 'b':   out.push_back('\b');    break;
-                        case 'n':   out.push_back('\n');    break;
-                        case 'r':   out.push_back('\r');    break;
-                        case 't':   out.push_back('\t');    break;
-                        case 'u': {
-                            // basic \uXXXX -> UTF-8
-                            if (pos + 4 > string.size()) error("Invalid \\u escape");
-                            unsigned code = 0;
-                            for (int k=0;k<4;++k) {
-                                char ch = string[pos++];
-                                posinfo.col++;
-                                code <<= 4;
-                                if (ch >= '0' && ch <= '9') code += static_cast<unsigned>(ch - '0');
-                                else if (ch >= 'a' && ch <= 'f') code += static_cast<unsigned>(10 + ch - 'a');
-                                else if (ch >= 'A' && ch <= 'F') code += static_cast<unsigned>(10 + ch - 'A');
-                                else error("Invalid hex in \\u escape");
-                            }
-                            // convert to UTF-8
-                            if (code <= 0x7F) out.push_back(static_cast<char>(code));
-                            else if (code <= 0x7FF) {
-                                out.push_back(static_cast<char>(0xC0 | ((code >> 6) & 0x1F)));
-                                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
-                            } else {
-                                out.push_back(static_cast<char>(0xE0 | ((code >> 12) & 0x0F)));
-                                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
-                                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
-                            }
-                        } break;
-                        default:
-                            error(std::string("Invalid escape \\") + e);
-                    }
-                } else {
-                    out.push_back(c);
-                    if (c == '\n') { posinfo.line++; posinfo.col = 1; }
-                    else posinfo.col++;
-                }
-            }
-            if (!found_closing_quote) error("Unterminated string");
-            return JsonValue(std::move(out));
+        bool JsonDeserializer::parse(std::string_view src, JsonSaxHandler& handler, ParseError& err_out) {
+            err_out = ParseError{};
+            JsonDeserializer deser{src};
+            deser.err = &err_out;
+            return deser.saxInternal(handler);
         }
 
-        JsonValue JsonDeserializer::parseObject() {
-            expectChar('{');
-            skipWhitespace();
-            JsonObject obj;
-            if (peek() == '}') { advance(); return JsonValue(std::move(obj)); }
-            while (true) {
-                skipWhitespace();
-                if (peek() != '"') error("Object keys must be strings");
-                JsonValue keyv = parseString();
-                skipWhitespace();
-                expectChar(':');
-                skipWhitespace();
-                JsonValue val = parseJsonValue();
-                obj.emplace(keyv.asString(), std::move(val));
-                skipWhitespace();
-                if (peek() == '}') { advance(); break; }
-                if (peek() == ',') { advance(); skipWhitespace(); continue; }
-                error("Expected ',' or '}' in object");
-            }
-            return JsonValue(std::move(obj));
+        bool JsonDeserializer::error(const std::string& msg, size_t at) {
+            *err = ParseError(msg, locate(string, at));
+            return false;
         }
+    #endif
 
-        JsonValue JsonDeserializer::parseArray() {
-            expectChar('[');
-            skipWhitespace();
-            JsonArray arr;
-            if (peek() == ']') { advance(); return JsonValue(std::move(arr)); }
-            while (true) {
-                skipWhitespace();
-                arr.push_back(parseJsonValue());
-                skipWhitespace();
-                if (peek() == ']') { advance(); break; }
-                if (peek() == ',') { advance(); skipWhitespace(); continue; }
-                error("Expected ',' or ']' in array");
-            }
-            return JsonValue(std::move(arr));
+        bool JsonDeserializer::error(const std::string& msg) {
+            return error(msg, pos);
         }
 
-        JsonValue JsonDeserializer::parseNull() {
-            if (string.compare(pos,4,"null") == 0) { 
-                pos += 4; 
-                posinfo.col += 4; 
-                return JsonValue(nullptr); 
+        // Line and column are only needed once something went wrong, so they are derived from the
+        // byte offset instead of being tracked for every consumed character.
+        ErrorPos JsonDeserializer::locate(std::string_view src, size_t offset) {
+            ErrorPos p;
+            if (offset > src.size()) offset = src.size();
+            const char* begin       = src.data();
+            const char* lineStart   = begin;
+            const char* end         = begin + offset;
+            while (lineStart < end) {
+                const char* nl = static_cast<const char*>(std::memchr(lineStart, '\n', static_cast<size_t>(end - lineStart)));
+                if (!nl) break;
+                p.line++;
+                lineStart = nl + 1;
             }
-            error("Invalid token, expected 'null'");
-            return JsonValue{};
+            p.col = static_cast<int>(end - lineStart) + 1;
+            return p;
         }
 
-        JsonValue JsonDeserializer::parseBool() {
-            if (string.compare(pos,4,"true") == 0) { 
-                pos += 4; 
-                posinfo.col += 4; 
-                return JsonValue(true); 
-            }
-            if (string.compare(pos,5,"false") == 0) { 
-                pos += 5; 
-                posinfo.col += 5; 
-                return JsonValue(false); 
+        void JsonDeserializer::prepare(std::vector<uint32_t>& tokens) {
+            if (string.size() >= HMS_JSON_STRUCTURAL_MIN_SIZE) {
+                size_t badUtf8;
+                // On malformed UTF-8 the byte by byte parser reruns the input so the first error
+                // in document order is reported, exactly as without the index.
+                if (detail::buildStructuralIndex(string, tokens, badUtf8) && badUtf8 == static_cast<size_t>(-1)) {
+                    token       = tokens.data();
+                    tokenEnd    = token + tokens.size();
+                    utf8Checked = true;
+                }
             }
-            error("Invalid token, expected 'true' or 'false'");
-            return JsonValue{};
         }
-    
-        void JsonDeserializer::expectChar(char c) {
-            if (peek() != c) error(std::string("Expected '") + c + "'");
-            advance();
+
+        bool JsonDeserializer::deserializeInternal(JsonValue& out) {
+            #ifdef HMS_JSON_STATS
+                detail::StatsRecorder stats(JsonStats::Parse, string.size());
+            #endif
+            #ifdef HMS_JSON_INTERN_KEYS
+                detail::ParseKeyScope keys;
+            #endif
+            std::vector<uint32_t> tokens;
+            prepare(tokens);
+            #ifdef HMS_JSON_STATS
+                stats.indexed();
+            #endif
+            nextToken();
+            if (!parseJsonValue(out)) return false;
+            nextToken();
+            if (pos != string.size()) return error("Trailing data after JSON");
+            #ifdef HMS_JSON_STATS
+                stats.succeeded(string.size());
+            #endif
+            return true;
         }
-    #else
-        JsonValue JsonDeserializer::deserialize(const std::string& src, ParseError& err_out) {
-            JsonDeserializer deser{src};
-            return deser.deserializeInternal(err_out);
+
+        // Moves pos to the start of the next token: the next structural index entry in two stage
+        // mode, the next non whitespace byte otherwise. Returns '\0' at the end of input.
+        char JsonDeserializer::nextToken() {
+            if (token) {
+                pos = token != tokenEnd ? *token++ : string.size();
+            } else {
+                while (pos < string.size() && isJsonSpace(string[pos])) pos++;
+            }
+            return pos < string.size() ? string[pos] : '\0';
         }
 
-        JsonValue JsonDeserializer::deserializeInternal(ParseError& err_out) {
-            err_out = ParseError{};
-            skipWhitespace();
-            JsonValue v = parseJsonValue(err_out);
-            if (!err_out.what.empty()) return JsonValue{};
-            skipWhitespace();
-            if (pos != string.size()) {
-                err_out = ParseError("Trailing data after JSON", posinfo);
-                return JsonValue{};
+        bool JsonDeserializer::endOfScalar() {
+            if (pos < string.size() && !isDelimiter(string[pos])) {
+                return error(std::string("Unexpected character '") + string[pos] + "'");
             }
-            return v;
+            return true;
         }
 
-        JsonValue JsonDeserializer::parseJsonValue(ParseError& err_out) {
-            if (pos >= string.size()) { err_out = ParseError("Unexpected end of input", posinfo); return JsonValue{}; }
+        bool JsonDeserializer::parseJsonValue(JsonValue& out) {
+            if (pos >= string.size()) return error("Unexpected end of input");
+            HMS_JSON_STATS_ADD(nodes, 1);
             char c = string[pos];
-            if (c == 'n') return parseNull(err_out);
-            if (c == 't' || c == 'f') return parseBool(err_out);
-            if (c == '"') return parseString(err_out);
-            if (c == '[') return parseArray(err_out);
-            if (c == '{') return parseObject(err_out);
-            if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) return parseNumber(err_out);
-            err_out = ParseError(std::string("Unexpected character '") + c + "'", posinfo);
-            return JsonValue{};
-        }
-    
-        JsonValue JsonDeserializer::parseNumber(ParseError& err_out) { 
-            size_t start = pos;
-            if (string[pos] == '-') advance();
-            while (pos < string.size() && std::isdigit(static_cast<unsigned char>(string[pos]))) advance();
-            if (pos < string.size() && string[pos] == '.') {
-                advance();
-                while (pos < string.size() && std::isdigit(static_cast<unsigned char>(string[pos]))) advance();
-            }
-            if (pos < string.size() && (string[pos] == 'e' || string[pos] == 'E')) {
-                advance();
-                if (string[pos] == '+' || string[pos] == '-') advance();
-                while (pos < string.size() && std::isdigit(static_cast<unsigned char>(string[pos]))) advance();
+            if (c == '"') {
+                std::string s;
+                if (!parseString(s)) return false;
+                out = JsonValue(std::move(s));
+                return true;
             }
-            std::string tok = string.substr(start, pos - start);
-            char *endptr = nullptr;
-            double d = std::strtod(tok.c_str(), &endptr);
-            if (endptr != tok.c_str() + tok.size()) {
-                err_out = ParseError("Invalid number format", posinfo);
-                return JsonValue{};
+            if (c == '{') return parseObject(out);
+            if (c == '[') return parseArray(out);
+            if (c == '-' || isDigit(c)) return parseNumber(out);
+            if (c == 't' || c == 'f') return parseBool(out);
+            if (c == 'n') return parseNull(out);
+            return error(std::string("Unexpected character '") + c + "'");
+        }
+
+        bool JsonDeserializer::parseNumber(JsonValue& out) {
+            const char* begin   = string.data();
+            const char* p       = begin + pos;
+            detail::NumberValue n;
+            detail::NumberStatus status = detail::parseNumber(p, begin + string.size(), n);
+            pos = static_cast<size_t>(p - begin);
+            if (status == detail::NumberStatus::Invalid)    return error("Invalid number format");
+            if (status == detail::NumberStatus::OutOfRange) return error("Number out of range");
+            switch (n.kind) {
+                case detail::NumberValue::Int64:    out = JsonValue(static_cast<long long>(n.i));            break;
+                case detail::NumberValue::UInt64:   out = JsonValue(static_cast<unsigned long long>(n.u));   break;
+                default:                            out = JsonValue(n.d);                                    break;
             }
-            return JsonValue(d);
+            return endOfScalar();
         }
-        
-        JsonValue JsonDeserializer::parseString(ParseError& err_out) {
-            if (!expectChar('"', err_out)) return JsonValue{};
-            std::string out;
-            bool found_closing_quote = false;
-            while (pos < string.size()) {
-                char c = string[pos++];
-                posinfo.col++;
-                if (c == '"') { found_closing_quote = true; break; }
-                if (c == '\\') {
-                    if (pos >= string.size()) { err_out = ParseError("Invalid escape", posinfo); return JsonValue{}; }
-                    char e = string[pos++];
-                    posinfo.col++;
-                    switch (e) {
-                        case '"': out.push_back('"'); break;
-                        case '\\': out.push_back('\\'); break;
-                        case '/': out.push_back('/'); break;
-                        case 'b': out.push_back('\b'); break;
-                        case 'f': out.push_back('\f'); break;
-                        case 'n': out.push_back('\n'); break;
-                        case 'r': out.push_back('\r'); break;
-                        case 't': out.push_back('\t'); break;
-                        case 'u': {
-                            if (pos + 4 > string.size()) { err_out = ParseError("Invalid \\u escape", posinfo); return JsonValue{}; }
-                            unsigned code = 0;
-                            for (int k=0;k<4;++k) {
-                                char ch = string[pos++];
-                                posinfo.col++;
-                                code <<= 4;
-                                if (ch >= '0' && ch <= '9') code += static_cast<unsigned>(ch - '0');
-                                else if (ch >= 'a' && ch <= 'f') code += static_cast<unsigned>(10 + ch - 'a');
-                                else if (ch >= 'A' && ch <= 'F') code += static_cast<unsigned>(10 + ch - 'A');
-                                else { err_out = ParseError("Invalid hex in \\u escape", posinfo); return JsonValue{}; }
+
+        bool JsonDeserializer::parseString(std::string& out) {
+            const char* begin   = string.data();
+            const char* end     = begin + string.size();
+            const char* p       = begin + pos + 1;         // past the opening quote
+            while (true) {
+                const char* run = p;
+                p = detail::scanStringLiteral(p, end, !utf8Checked);
+                out.append(run, static_cast<size_t>(p - run));
+                if (p >= end) { pos = string.size(); return error("Unterminated string"); }
+
+                char c = *p;
+                if (c == '"') { pos = static_cast<size_t>(p - begin) + 1; return true; }
+
+                if (c & 0x80) {
+                    size_t len = 1;
+                    if (!utf8Checked) {
+                        len = detail::utf8SequenceLength(reinterpret_cast<const unsigned char*>(p), reinterpret_cast<const unsigned char*>(end));
+                        if (!len) return error("Invalid UTF-8", static_cast<size_t>(p - begin));
+                    }
+                    out.append(p, len);
+                    p += len;
+                    continue;
+                }
+
+                // backslash
+                pos = static_cast<size_t>(++p - begin);
+                if (p >= end) return error("Invalid escape");
+                char e = *p++;
+                pos++;
+                switch (e) {
+                    case '"':   out.push_back('"');     break;
+                    case '\\':  out.push_back('\\');    break;
+                    case '/':   out.push_back('/');     break;
+                    case 'b':   out.push_back('\b');    break;
+                    case 'f':   out.push_back('\f');    break;
+                    case 'n':   out.push_back('\n');    break;
+                    case 'r':   out.push_back('\r');    break;
+                    case 't':   out.push_back('\t');    break;
+                    case 'u': {
+                        unsigned code = 0;
+                        for (int unit = 0; ; ++unit) {
+                            if (end - p < 4) return error("Invalid \\u escape");
+                            unsigned part = 0;
+                            for (int k = 0; k < 4; ++k) {
+                                char ch = *p++;
+                                pos++;
+                                part <<= 4;
+                                if (ch >= '0' && ch <= '9') part += static_cast<unsigned>(ch - '0');
+                                else if (ch >= 'a' && ch <= 'f') part += static_cast<unsigned>(10 + ch - 'a');
+                                else if (ch >= 'A' && ch <= 'F') part += static_cast<unsigned>(10 + ch - 'A');
+                                else return error("Invalid hex in \\u escape");
                             }
-                            if (code <= 0x7F) out.push_back(static_cast<char>(code));
-                            else if (code <= 0x7FF) {
-                                out.push_back(static_cast<char>(0xC0 | ((code >> 6) & 0x1F)));
-                                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                            if (unit == 0) {
+                                code = part;
+                                if (code >= 0xDC00 && code <= 0xDFFF) return error("Invalid surrogate in \\u escape");
+                                if (code < 0xD800 || code > 0xDBFF) break;
+                                // high surrogate, the low half must follow as a second escape
+                                if (end - p < 2 || p[0] != '\\' || p[1] != 'u') return error("Invalid surrogate in \\u escape");
+                                p += 2;
+                                pos += 2;
                             } else {
-                                out.push_back(static_cast<char>(0xE0 | ((code >> 12) & 0x0F)));
-                                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
-                                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                                if (part < 0xDC00 || part > 0xDFFF) return error("Invalid surrogate in \\u escape");
+                                code = 0x10000 + ((code - 0xD800) << 10) + (part - 0xDC00);
+                                break;
                             }
-                        } break;
-                        default:
-                            err_out = ParseError(std::string("Invalid escape \\") + e, posinfo); return JsonValue{};
-                    }
-                } else {
-                    out.push_back(c);
-                    if (c == '\n') { posinfo.line++; posinfo.col = 1; }
+                        }
+                        detail::appendUtf8(out, code);
+                    } break;
+                    default:
+                        return error(std::string("Invalid escape \\") + e);
                 }
             }
-            if (!found_closing_quote) { err_out = ParseError("Unterminated string", posinfo); return JsonValue{}; }
-            return JsonValue(std::move(out));
         }
-        
-        JsonValue JsonDeserializer::parseObject(ParseError& err_out) {
-            if (!expectChar('{', err_out)) return JsonValue{};
-            skipWhitespace();
+
+        bool JsonDeserializer::parseObject(JsonValue& out) {
+            #ifdef HMS_JSON_STATS
+                detail::StatsDepth depth;
+            #endif
+            pos++;
             JsonObject obj;
-            if (peek() == '}') { advance(); return JsonValue(std::move(obj)); }
+            char c = nextToken();
+            if (c == '}') { pos++; out = JsonValue(std::move(obj)); return true; }
             while (true) {
-                skipWhitespace();
-                if (peek() != '"') { err_out = ParseError("Object keys must be strings", posinfo); return JsonValue{}; }
-                JsonValue keyv = parseString(err_out);
-                if (!err_out.what.empty()) return JsonValue{};
-                skipWhitespace();
-                if (!expectChar(':', err_out)) return JsonValue{};
-                skipWhitespace();
-                JsonValue val = parseJsonValue(err_out);
-                if (!err_out.what.empty()) return JsonValue{};
-                obj.emplace(keyv.asString(), std::move(val));
-                skipWhitespace();
-                if (peek() == '}') { advance(); break; }
-                if (peek() == ',') { advance(); skipWhitespace(); continue; }
-                err_out = ParseError("Expected ',' or '}' in object", posinfo);
-                return JsonValue{};
+                if (c != '"') return error("Object keys must be strings");
+                #ifdef HMS_JSON_INTERN_KEYS
+                    std::string_view text;
+                    if (!saxString(text)) return false;
+                    JsonKey key(text);
+                #else
+                    std::string key;
+                    if (!parseString(key)) return false;
+                #endif
+                if (nextToken() != ':') return error("Expected ':'");
+                pos++;
+                nextToken();
+                JsonValue val;
+                if (!parseJsonValue(val)) return false;
+                obj.emplace(std::move(key), std::move(val));
+                c = nextToken();
+                if (c == '}') { pos++; break; }
+                if (c == ',') { pos++; c = nextToken(); continue; }
+                return error("Expected ',' or '}' in object");
             }
-            return JsonValue(std::move(obj));
+            out = JsonValue(std::move(obj));
+            return true;
         }
-        
-        JsonValue JsonDeserializer::parseArray(ParseError& err_out) {
-            if (!expectChar('[', err_out)) return JsonValue{};
-            skipWhitespace();
+
+        bool JsonDeserializer::parseArray(JsonValue& out) {
+            #ifdef HMS_JSON_STATS
+                detail::StatsDepth depth;
+            #endif
+            pos++;
             JsonArray arr;
-            if (peek() == ']') { advance(); return JsonValue(std::move(arr)); }
+            char c = nextToken();
+            if (c == ']') { pos++; out = JsonValue(std::move(arr)); return true; }
             while (true) {
-                skipWhitespace();
-                arr.push_back(parseJsonValue(err_out));
-                if (!err_out.what.empty()) return JsonValue{};
-                skipWhitespace();
-                if (peek() == ']') { advance(); break; }
-                if (peek() == ',') { advance(); skipWhitespace(); continue; }
-                err_out = ParseError("Expected ',' or ']' in array", posinfo);
-                return JsonValue{};
+                arr.emplace_back();
+                if (!parseJsonValue(arr.back())) return false;
+                c = nextToken();
+                if (c == ']') { pos++; break; }
+                if (c == ',') { pos++; nextToken(); continue; }
+                return error("Expected ',' or ']' in array");
             }
-            return JsonValue(std::move(arr));
+            out = JsonValue(std::move(arr));
+            return true;
         }
-        
-        JsonValue JsonDeserializer::parseNull(ParseError& err_out) {
-            if (string.compare(pos,4,"null") == 0) { 
-                pos += 4; 
-                posinfo.col += 4; 
-                return JsonValue(nullptr); 
+
+        bool JsonDeserializer::parseNull(JsonValue& out) {
+            if (string.compare(pos, 4, "null") == 0) {
+                pos += 4;
+                out = JsonValue(nullptr);
+                return endOfScalar();
             }
-            err_out = ParseError("Invalid token, expected 'null'", posinfo);
-            return JsonValue{};
+            return error("Invalid token, expected 'null'");
         }
-        
-        JsonValue JsonDeserializer::parseBool(ParseError& err_out) {
-            if (string.compare(pos,4,"true") == 0) { 
-                pos += 4; 
-                posinfo.col += 4; 
-                return JsonValue(true); 
+
+        bool JsonDeserializer::parseBool(JsonValue& out) {
+            if (string.compare(pos, 4, "true") == 0) {
+                pos += 4;
+                out = JsonValue(true);
+                return endOfScalar();
             }
-            if (string.compare(pos,5,"false") == 0) { 
-                pos += 5; 
-                posinfo.col += 5; 
-                return JsonValue(false); 
+            if (string.compare(pos, 5, "false") == 0) {
+                pos += 5;
+                out = JsonValue(false);
+                return endOfScalar();
             }
-            err_out = ParseError("Invalid token, expected 'true' or 'false'", posinfo);
-            return JsonValue{};
+            return error("Invalid token, expected 'true' or 'false'");
         }
-        
-        bool JsonDeserializer::expectChar(char c, ParseError& err_out) {
-            if (peek() != c) { err_out = ParseError(std::string("Expected '") + c + "'", posinfo); return false; }
-            advance(); return true;
+
+        /*
+         * Event parser. It shares tokenizing, string decoding and scalar parsing with the tree
+         * builder above, scalars go through a temporary JsonValue which never allocates.
+         */
+        bool JsonDeserializer::saxInternal(JsonSaxHandler& h) {
+            #ifdef HMS_JSON_STATS
+                detail::StatsRecorder stats(JsonStats::Parse, string.size());
+            #endif
+            std::vector<uint32_t> tokens;
+            prepare(tokens);
+            #ifdef HMS_JSON_STATS
+                stats.indexed();
+            #endif
+            nextToken();
+            if (!saxValue(h)) return false;
+            nextToken();
+            if (pos != string.size()) return error("Trailing data after JSON");
+            #ifdef HMS_JSON_STATS
+                stats.succeeded(string.size());
+            #endif
+            return true;
         }
-    #endif
 
-        void JsonDeserializer::advance() {
-            if (pos >= string.size()) return;
-            if (string[pos] == '\n') { posinfo.line++; posinfo.col = 1; }
-            else posinfo.col++;
-            pos++;
+        bool JsonDeserializer::accepted(bool ok, size_t at) {
+            return ok || error("Parsing stopped by handler", at);
         }
 
-        char JsonDeserializer::peek() const {
-            if (pos >= string.size()) return '\0';
-            return string[pos];
+        // Literals without escapes are handed out as views into the input.
+        bool JsonDeserializer::saxString(std::string_view& out) {
+            const char* begin   = string.data();
+            const char* end     = begin + string.size();
+            const char* p       = detail::scanStringLiteral(begin + pos + 1, end, !utf8Checked);
+            if (p < end && *p == '"') {
+                out = std::string_view(begin + pos + 1, static_cast<size_t>(p - begin - pos - 1));
+                pos = static_cast<size_t>(p - begin) + 1;
+                return true;
+            }
+            scratch.clear();
+            if (!parseString(scratch)) return false;
+            out = scratch;
+            return true;
         }
 
-        void JsonDeserializer::skipWhitespace() {
-            while (
-                pos < string.size() && std::isspace(
-                    static_cast<unsigned char>(string[pos])
-                )
-            ) advance();
+        bool JsonDeserializer::saxValue(JsonSaxHandler& h) {
+            if (pos >= string.size()) return error("Unexpected end of input");
+            size_t start = pos;
+            char c = string[pos];
+            // Strings and containers are counted here, the other scalars by parseJsonValue().
+            if (c == '"') {
+                HMS_JSON_STATS_ADD(nodes, 1);
+                std::string_view s;
+                return saxString(s) && accepted(h.onString(s), start);
+            }
+            if (c == '{') {
+                HMS_JSON_STATS_ADD(nodes, 1);
+                #ifdef HMS_JSON_STATS
+                    detail::StatsDepth depth;
+                #endif
+                if (!accepted(h.onStartObject(), start)) return false;
+                pos++;
+                c = nextToken();
+                if (c == '}') { pos++; return accepted(h.onEndObject(), pos - 1); }
+                while (true) {
+                    if (c != '"') return error("Object keys must be strings");
+                    size_t keyAt = pos;
+                    std::string_view key;
+                    if (!saxString(key) || !accepted(h.onKey(key), keyAt)) return false;
+                    if (nextToken() != ':') return error("Expected ':'");
+                    pos++;
+                    nextToken();
+                    if (!saxValue(h)) return false;
+                    c = nextToken();
+                    if (c == '}') { pos++; return accepted(h.onEndObject(), pos - 1); }
+                    if (c == ',') { pos++; c = nextToken(); continue; }
+                    return error("Expected ',' or '}' in object");
+                }
+            }
+            if (c == '[') {
+                HMS_JSON_STATS_ADD(nodes, 1);
+                #ifdef HMS_JSON_STATS
+                    detail::StatsDepth depth;
+                #endif
+                if (!accepted(h.onStartArray(), start)) return false;
+                pos++;
+                c = nextToken();
+                if (c == ']') { pos++; return accepted(h.onEndArray(), pos - 1); }
+                while (true) {
+                    if (!saxValue(h)) return false;
+                    c = nextToken();
+                    if (c == ']') { pos++; return accepted(h.onEndArray(), pos - 1); }
+                    if (c == ',') { pos++; nextToken(); continue; }
+                    return error("Expected ',' or ']' in array");
+                }
+            }
+
+            JsonValue v;
+            if (!parseJsonValue(v)) return false;
+            if (auto i = v.getIf<int64_t>())  return accepted(h.onInteger(*i), start);
+            if (auto u = v.getIf<uint64_t>()) return accepted(h.onUnsigned(*u), start);
+            if (auto d = v.getIf<double>())   return accepted(h.onNumber(*d), start);
+            if (auto b = v.getIf<bool>())     return accepted(h.onBool(*b), start);
+            return accepted(h.onNull(), start);
         }
 }
@@ -0,0 +1,47 @@
+#include "HMS_JSON_Document.h"
+#include "HMS_JSON_Deserializer.h"
+
+namespace HMS {
+    #if HMS_JSON_EXCEPTIONS_ENABLED
+        void JsonDocument::parse(std::string_view src) {
+            clear();
+            JsonArenaScope scope(arenaStore);
+            #ifdef HMS_JSON_INTERN_KEYS
+                JsonKeyScope keyScope(keys);
+            #endif
+            rootValue = JsonDeserializer::deserialize(src);
+        }
+    #else
+        bool JsonDocument::parse(std::string_view src, ParseError& err_out) {
+            clear();
+            JsonArenaScope scope(arenaStore);
+            #ifdef HMS_JSON_INTERN_KEYS
+                JsonKeyScope keyScope(keys);
+            #endif
+            rootValue = JsonDeserializer::deserialize(src, err_out);
+            if (err_out) { clear(); return false; }
+            return true;
+        }
+    #endif
+
+    JsonValue& JsonDocument::operator[](const std::string& key) {
+        JsonArenaScope scope(arenaStore);
+        #ifdef HMS_JSON_INTERN_KEYS
+            JsonKeyScope keyScope(keys);
+        #endif
+        return rootValue[key];
+    }
+
+    JsonValue& JsonDocument::operator[](std::size_t idx) {
+        JsonArenaScope scope(arenaStore);
+        return rootValue[idx];
+    }
+
+    void JsonDocument::clear() {
+        rootValue = JsonValue{};
+        arenaStore.release();
+        #ifdef HMS_JSON_INTERN_KEYS
+            keys.clear();
+        #endif
+    }
+}
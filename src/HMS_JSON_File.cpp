@@ -0,0 +1,141 @@
+#include "HMS_JSON_File.h"
+#include "HMS_JSON_Deserializer.h"
+
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define HMS_JSON_HAVE_MMAP 1
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+namespace HMS {
+    JsonMappedFile::JsonMappedFile(JsonMappedFile&& other) noexcept
+        : data(other.data), size(other.size), mapped(other.mapped), buffer(std::move(other.buffer)) {
+        other.data      = nullptr;
+        other.size      = 0;
+        other.mapped    = false;
+    }
+
+    JsonMappedFile& JsonMappedFile::operator=(JsonMappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            data            = other.data;
+            size            = other.size;
+            mapped          = other.mapped;
+            buffer          = std::move(other.buffer);
+            other.data      = nullptr;
+            other.size      = 0;
+            other.mapped    = false;
+        }
+        return *this;
+    }
+
+    void JsonMappedFile::close() {
+        #if HMS_JSON_HAVE_MMAP
+            if (mapped) munmap(const_cast<char*>(data), size);
+        #endif
+        buffer.reset();
+        data    = nullptr;
+        size    = 0;
+        mapped  = false;
+    }
+
+    #if HMS_JSON_EXCEPTIONS_ENABLED
+        void JsonMappedFile::open(const char* path) {
+            std::string why;
+            if (!load(path, why)) throw ParseError(why, ErrorPos{});
+        }
+    #else
+        bool JsonMappedFile::open(const char* path, ParseError& err_out) {
+            err_out = ParseError{};
+            std::string why;
+            if (load(path, why)) return true;
+            err_out = ParseError(why, ErrorPos{});
+            return false;
+        }
+    #endif
+
+    bool JsonMappedFile::load(const char* path, std::string& why) {
+        close();
+        #if HMS_JSON_HAVE_MMAP
+            int fd = ::open(path, O_RDONLY);
+            if (fd < 0) { why = std::string("Cannot open file '") + path + "'"; return false; }
+            struct stat st;
+            if (fstat(fd, &st) != 0) { ::close(fd); why = std::string("Cannot stat file '") + path + "'"; return false; }
+            if (S_ISREG(st.st_mode)) {
+                size = static_cast<size_t>(st.st_size);
+                if (size == 0) { ::close(fd); return true; }
+                void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (p == MAP_FAILED) { size = 0; why = std::string("Cannot map file '") + path + "'"; return false; }
+                // The parser reads front to back; let the kernel read ahead aggressively.
+                madvise(p, size, MADV_SEQUENTIAL);
+                data    = static_cast<const char*>(p);
+                mapped  = true;
+                return true;
+            }
+            ::close(fd);                                // pipes and devices are read below
+        #endif
+
+        FILE* f = std::fopen(path, "rb");
+        if (!f) { why = std::string("Cannot open file '") + path + "'"; return false; }
+        size_t capacity = 0;
+        size_t used     = 0;
+        while (true) {
+            if (used == capacity) {
+                size_t grown = capacity ? capacity * 2 : 64 * 1024;
+                std::unique_ptr<char[]> next(new char[grown]);
+                if (used) std::memcpy(next.get(), buffer.get(), used);
+                buffer      = std::move(next);
+                capacity    = grown;
+            }
+            size_t n = std::fread(buffer.get() + used, 1, capacity - used, f);
+            used += n;
+            if (n == 0) break;
+        }
+        bool failed = std::ferror(f) != 0;
+        std::fclose(f);
+        if (failed) { close(); why = std::string("Cannot read file '") + path + "'"; return false; }
+        data = buffer.get();
+        size = used;
+        return true;
+    }
+
+    #if HMS_JSON_EXCEPTIONS_ENABLED
+        void JsonFile::open(const char* path, JsonFileMode mode) {
+            rootValue = JsonValue{};
+            source.open(path);
+            if (mode == JsonFileMode::Tree) {
+                rootValue = JsonDeserializer::deserialize(source.text());
+                source.close();                                 // the tree owns copies of everything
+            }
+        }
+
+        JsonFile deserializeFile(const char* path, JsonFileMode mode) {
+            JsonFile f;
+            f.open(path, mode);
+            return f;
+        }
+    #else
+        bool JsonFile::open(const char* path, JsonFileMode mode, ParseError& err_out) {
+            rootValue = JsonValue{};
+            if (!source.open(path, err_out)) return false;
+            if (mode == JsonFileMode::Tree) {
+                rootValue = JsonDeserializer::deserialize(source.text(), err_out);
+                if (err_out) return false;
+                source.close();                                 // the tree owns copies of everything
+            }
+            return true;
+        }
+
+        JsonFile deserializeFile(const char* path, ParseError& err_out, JsonFileMode mode) {
+            JsonFile f;
+            f.open(path, mode, err_out);
+            return f;
+        }
+    #endif
+}
@@ -0,0 +1,61 @@
+#include "HMS_JSON_Key.h"
+
+#ifdef HMS_JSON_INTERN_KEYS
+
+#include <new>
+
+namespace HMS {
+    JsonKey::JsonKey(std::string_view s) {
+        if (JsonKeyTable* table = JsonKeyTable::current()) *this = table->intern(s);
+        else if (!s.empty()) rep = make(s, detail::keyHash(s));
+    }
+
+    JsonKey::Rep* JsonKey::make(std::string_view s, size_t hash) {
+        void* mem   = ::operator new(offsetof(Rep, text) + s.size() + 1);
+        Rep* r      = new (mem) Rep;
+        r->refs.store(1, std::memory_order_relaxed);
+        r->size     = static_cast<uint32_t>(s.size());
+        r->hash     = static_cast<uint32_t>(hash);
+        std::memcpy(r->text, s.data(), s.size());
+        r->text[s.size()] = '\0';
+        return r;
+    }
+
+    void JsonKey::release() {
+        if (rep && rep->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            rep->~Rep();
+            ::operator delete(rep);
+        }
+        rep = nullptr;
+    }
+
+    JsonKey JsonKeyTable::intern(std::string_view s) {
+        if (s.empty()) return JsonKey();
+        if ((count + 1) * 2 > slots.size()) grow();
+        size_t hash = detail::keyHash(s);
+        size_t mask = slots.size() - 1;
+        size_t slot = hash & mask;
+        for (; !slots[slot].empty(); slot = (slot + 1) & mask) {
+            const JsonKey& k = slots[slot];
+            if (k.hash() == hash && k.view() == s) return k;
+        }
+        slots[slot].rep = JsonKey::make(s, hash);
+        count++;
+        return slots[slot];
+    }
+
+    void JsonKeyTable::grow() {
+        std::vector<JsonKey> old;
+        old.swap(slots);
+        slots.resize(old.empty() ? 64 : old.size() * 2);
+        size_t mask = slots.size() - 1;
+        for (JsonKey& k : old) {
+            if (k.empty()) continue;
+            size_t slot = k.hash() & mask;
+            while (!slots[slot].empty()) slot = (slot + 1) & mask;
+            slots[slot] = std::move(k);
+        }
+    }
+}
+
+#endif
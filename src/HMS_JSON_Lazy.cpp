@@ -0,0 +1,257 @@
+#include "HMS_JSON_Lazy.h"
+#include "HMS_JSON_Deserializer.h"
+#include "HMS_JSON_Skip.h"
+#include "HMS_JSON_Strings.h"
+
+namespace HMS {
+    JsonLazyValue::JsonLazyValue(std::string_view s) : src(s) {
+        at = detail::skipSpace(src, 0);
+        if (at >= src.size()) {
+            state   = Malformed;
+            reason  = "Unexpected end of input";
+            return;
+        }
+        state   = Ok;
+        reason  = nullptr;
+        // One bracket and quote scan over the root finds where it ends. Anything the scan cannot
+        // make sense of is left for the lookups or the parser to report where they hit it.
+        const char* why = nullptr;
+        size_t end = detail::skipValue(src, at, why);
+        if (end == detail::SKIP_FAILED) return;
+        end = detail::skipSpace(src, end);
+        if (end < src.size()) *this = fail(Malformed, "Trailing data after JSON", end);
+    }
+
+    JsonLazyValue JsonLazyValue::fail(State s, const char* why, size_t where) const {
+        JsonLazyValue r = *this;
+        r.state     = s;
+        r.reason    = why;
+        r.at        = where;
+        return r;
+    }
+
+    // p is the first non whitespace byte of a member, the cursor lands on its value.
+    JsonLazyValue JsonLazyValue::member(size_t p) const {
+        if (p >= src.size()) return fail(Malformed, "Unexpected end of input", p);
+        if (src[p] != '"') return fail(Malformed, "Object keys must be strings", p);
+        size_t q = detail::skipString(src, p);
+        if (q == detail::SKIP_FAILED) return fail(Malformed, "Unterminated string", src.size());
+        q = detail::skipSpace(src, q);
+        if (q >= src.size() || src[q] != ':') return fail(Malformed, "Expected ':'", q);
+        q = detail::skipSpace(src, q + 1);
+        if (q >= src.size()) return fail(Malformed, "Unexpected end of input", q);
+        return JsonLazyValue(src, q, p, InObject);
+    }
+
+    JsonLazyValue JsonLazyValue::element(size_t p) const {
+        if (p >= src.size()) return fail(Malformed, "Unexpected end of input", p);
+        return JsonLazyValue(src, p, 0, InArray);
+    }
+
+    JsonLazyValue JsonLazyValue::first() const {
+        if (state != Ok) return *this;
+        char c = src[at];
+        if (c != '{' && c != '[') return fail(Missing, "Expected object or array", at);
+        size_t p = detail::skipSpace(src, at + 1);
+        if (p < src.size() && src[p] == (c == '{' ? '}' : ']')) return fail(Missing, "Value not found", at);
+        return c == '{' ? member(p) : element(p);
+    }
+
+    JsonLazyValue JsonLazyValue::next() const {
+        if (state != Ok) return *this;
+        if (parent == Root) return fail(Missing, "Value not found", at);
+        const char* why = nullptr;
+        size_t p = detail::skipValue(src, at, why);
+        if (p == detail::SKIP_FAILED) return fail(Malformed, why, src[at] == '"' || src[at] == '{' || src[at] == '[' ? src.size() : at);
+        p = detail::skipSpace(src, p);
+        if (p >= src.size()) return fail(Malformed, "Unexpected end of input", p);
+        char c = src[p];
+        if (c == ',') {
+            p = detail::skipSpace(src, p + 1);
+            return parent == InObject ? member(p) : element(p);
+        }
+        if (c == (parent == InObject ? '}' : ']')) return fail(Missing, "Value not found", p);
+        return fail(Malformed, parent == InObject ? "Expected ',' or '}' in object" : "Expected ',' or ']' in array", p);
+    }
+
+    JsonLazyValue JsonLazyValue::operator[](std::string_view key) const {
+        if (state != Ok) return *this;
+        if (!isObject()) return fail(Missing, "Expected object", at);
+        JsonLazyValue m = first();
+        for (; m.state == Ok; m = m.next()) {
+            if (m.keyEquals(key)) return m;
+        }
+        if (m.state == Malformed) return m;
+        return fail(Missing, "Key not found", at);
+    }
+
+    JsonLazyValue JsonLazyValue::operator[](int idx) const {
+        if (state != Ok) return *this;
+        if (idx < 0) return fail(Missing, "Index out of range", at);
+        return (*this)[static_cast<std::size_t>(idx)];
+    }
+
+    JsonLazyValue JsonLazyValue::operator[](std::size_t idx) const {
+        if (state != Ok) return *this;
+        if (!isArray()) return fail(Missing, "Expected array", at);
+        JsonLazyValue m = first();
+        for (std::size_t i = 0; i < idx && m.state == Ok; ++i) m = m.next();
+        if (m.state != Missing) return m;
+        return fail(Missing, "Index out of range", at);
+    }
+
+    std::size_t JsonLazyValue::size() const {
+        std::size_t n = 0;
+        for (JsonLazyValue m = first(); m.state == Ok; m = m.next()) n++;
+        return n;
+    }
+
+    std::string JsonLazyValue::key() const {
+        std::string out;
+        if (state == Ok && parent == InObject) decodeKey(out);
+        return out;
+    }
+
+    std::string_view JsonLazyValue::raw() const {
+        if (state != Ok) return {};
+        const char* why = nullptr;
+        size_t end = detail::skipValue(src, at, why);
+        return end == detail::SKIP_FAILED ? src.substr(at) : src.substr(at, end - at);
+    }
+
+    // Keys without escapes are compared in place, which is what nearly every lookup hits.
+    bool JsonLazyValue::keyEquals(std::string_view key) const {
+        const char* begin   = src.data() + keyAt + 1;
+        const char* end     = src.data() + src.size();
+        const char* q       = detail::scanStringLiteral(begin, end, false);
+        if (q < end && *q == '"') return std::string_view(begin, static_cast<size_t>(q - begin)) == key;
+        std::string decoded;
+        return decodeKey(decoded) && decoded == key;
+    }
+
+    bool JsonLazyValue::decodeKey(std::string& out) const {
+        JsonDeserializer deser{src};
+        deser.pos = keyAt;
+        #if HMS_JSON_EXCEPTIONS_ENABLED
+            try {
+                return deser.parseString(out);
+            } catch (const ParseError&) {
+                out.clear();
+                return false;
+            }
+        #else
+            ParseError err;
+            deser.err = &err;
+            if (deser.parseString(out)) return true;
+            out.clear();
+            return false;
+        #endif
+    }
+
+    bool JsonLazyValue::load(JsonValue& out, ParseError* err) const {
+        if (state != Ok) return report(reason, at, err);
+        #ifdef HMS_JSON_INTERN_KEYS
+            detail::ParseKeyScope keys;
+        #endif
+        JsonDeserializer deser{src};
+        deser.pos = at;
+        #if !HMS_JSON_EXCEPTIONS_ENABLED
+            deser.err = err;
+        #endif
+        if (!deser.parseJsonValue(out)) return false;
+        if (parent != Root) return true;
+        size_t end = detail::skipSpace(src, deser.pos);
+        return end == src.size() || report("Trailing data after JSON", end, err);
+    }
+
+    bool JsonLazyValue::loadAs(JsonValue& out, bool (JsonValue::*is)() const, const char* expected, ParseError* err) const {
+        if (!load(out, err)) return false;
+        if (!(out.*is)()) return report(expected, at, err);
+        return true;
+    }
+
+    #if HMS_JSON_EXCEPTIONS_ENABLED
+        bool JsonLazyValue::report(const char* msg, size_t where, ParseError*) const {
+            throw ParseError(msg, JsonDeserializer::locate(src, where));
+        }
+
+        JsonValue JsonLazyValue::materialize() const {
+            JsonValue v;
+            load(v, nullptr);
+            return v;
+        }
+
+        bool JsonLazyValue::asBool() const {
+            JsonValue v;
+            loadAs(v, &JsonValue::isBool, "Expected boolean", nullptr);
+            return v.asBool();
+        }
+
+        double JsonLazyValue::asNumber() const {
+            JsonValue v;
+            loadAs(v, &JsonValue::isNumber, "Expected number", nullptr);
+            return v.asNumber();
+        }
+
+        int64_t JsonLazyValue::asInt64() const {
+            JsonValue v;
+            loadAs(v, &JsonValue::isNumber, "Expected number", nullptr);
+            return v.asInt64();
+        }
+
+        uint64_t JsonLazyValue::asUInt64() const {
+            JsonValue v;
+            loadAs(v, &JsonValue::isNumber, "Expected number", nullptr);
+            return v.asUInt64();
+        }
+
+        std::string JsonLazyValue::asString() const {
+            JsonValue v;
+            loadAs(v, &JsonValue::isString, "Expected string", nullptr);
+            return std::move(*v.getIf<std::string>());
+        }
+    #else
+        bool JsonLazyValue::report(const char* msg, size_t where, ParseError* err) const {
+            *err = ParseError(msg, JsonDeserializer::locate(src, where));
+            return false;
+        }
+
+        JsonValue JsonLazyValue::materialize(ParseError& err_out) const {
+            err_out = ParseError{};
+            JsonValue v;
+            if (!load(v, &err_out)) return JsonValue{};
+            return v;
+        }
+
+        bool JsonLazyValue::asBool(ParseError& err_out) const {
+            err_out = ParseError{};
+            JsonValue v;
+            return loadAs(v, &JsonValue::isBool, "Expected boolean", &err_out) && v.asBool();
+        }
+
+        double JsonLazyValue::asNumber(ParseError& err_out) const {
+            err_out = ParseError{};
+            JsonValue v;
+            return loadAs(v, &JsonValue::isNumber, "Expected number", &err_out) ? v.asNumber() : 0.0;
+        }
+
+        int64_t JsonLazyValue::asInt64(ParseError& err_out) const {
+            err_out = ParseError{};
+            JsonValue v;
+            return loadAs(v, &JsonValue::isNumber, "Expected number", &err_out) ? v.asInt64() : 0;
+        }
+
+        uint64_t JsonLazyValue::asUInt64(ParseError& err_out) const {
+            err_out = ParseError{};
+            JsonValue v;
+            return loadAs(v, &JsonValue::isNumber, "Expected number", &err_out) ? v.asUInt64() : 0;
+        }
+
+        std::string JsonLazyValue::asString(ParseError& err_out) const {
+            err_out = ParseError{};
+            JsonValue v;
+            if (!loadAs(v, &JsonValue::isString, "Expected string", &err_out)) return std::string{};
+            return std::move(*v.getIf<std::string>());
+        }
+    #endif
+}
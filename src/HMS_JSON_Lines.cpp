@@ -0,0 +1,110 @@
+#include "HMS_JSON_Lines.h"
+#include "HMS_JSON_Deserializer.h"
+#include "HMS_JSON_Serializer.h"
+#include "HMS_JSON_ThreadPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace HMS {
+    namespace {
+        constexpr size_t TASK_RECORDS = 32;     // records per pool task, keeps the shared counter cold
+
+        struct RecordError {
+            bool        failed = false;
+            std::string msg;
+            ErrorPos    pos;
+        };
+
+        inline bool isBlank(std::string_view s) {
+            for (char c : s) if (c != ' ' && c != '\t' && c != '\r') return false;
+            return true;
+        }
+    }
+
+    #if HMS_JSON_EXCEPTIONS_ENABLED
+        std::vector<JsonValue> JsonLinesReader::parseAll(std::string_view src) {
+            std::vector<JsonValue> all;
+            forEach(src, [&](JsonValue& v, size_t) { all.push_back(std::move(v)); return true; });
+            return all;
+        }
+    #else
+        std::vector<JsonValue> JsonLinesReader::parseAll(std::string_view src, ParseError& err_out) {
+            std::vector<JsonValue> all;
+            if (!forEach(src, [&](JsonValue& v, size_t) { all.push_back(std::move(v)); return true; }, err_out)) all.clear();
+            return all;
+        }
+    #endif
+
+    bool JsonLinesReader::run(std::string_view src, Visitor visitor, void* ctx, ParseError* err) {
+        std::vector<std::string_view>   records;
+        std::vector<size_t>             lines;
+        std::vector<JsonValue>          values;
+        std::vector<RecordError>        errors;
+        const char* data    = src.data();
+        size_t pos          = 0;
+        size_t line         = 0;
+
+        while (pos < src.size()) {
+            records.clear();
+            lines.clear();
+            while (pos < src.size() && records.size() < HMS_JSON_LINES_BATCH) {
+                const char* nl  = static_cast<const char*>(std::memchr(data + pos, '\n', src.size() - pos));
+                size_t end      = nl ? static_cast<size_t>(nl - data) : src.size();
+                std::string_view rec(data + pos, end - pos);
+                line++;
+                pos = end + 1;
+                if (isBlank(rec)) continue;
+                records.push_back(rec);
+                lines.push_back(line);
+            }
+
+            values.clear();
+            values.resize(records.size());
+            errors.clear();
+            errors.resize(records.size());
+            size_t tasks = (records.size() + TASK_RECORDS - 1) / TASK_RECORDS;
+            detail::parallelFor(tasks, threads, [&](size_t t) {
+                JsonArenaScope heap(nullptr);                           // tasks also run on the caller
+                #ifdef HMS_JSON_INTERN_KEYS
+                    detail::ParseKeyScope keys;                         // shared by the records of this task
+                #endif
+                size_t last = std::min(records.size(), (t + 1) * TASK_RECORDS);
+                for (size_t i = t * TASK_RECORDS; i < last; ++i) {
+                    #if HMS_JSON_EXCEPTIONS_ENABLED
+                        try {
+                            values[i] = JsonDeserializer::deserialize(records[i]);
+                        } catch (const ParseError& e) {
+                            errors[i] = RecordError{true, e.what(), e.pos};
+                        }
+                    #else
+                        ParseError e;
+                        values[i] = JsonDeserializer::deserialize(records[i], e);
+                        if (e) errors[i] = RecordError{true, e.what, e.pos};
+                    #endif
+                }
+            });
+
+            for (size_t i = 0; i < records.size(); ++i) {
+                if (errors[i].failed) {
+                    ErrorPos at{static_cast<int>(lines[i]) + errors[i].pos.line - 1, errors[i].pos.col};
+                    #if HMS_JSON_EXCEPTIONS_ENABLED
+                        (void)err;
+                        throw ParseError(errors[i].msg, at);
+                    #else
+                        *err = ParseError(errors[i].msg, at);
+                        return false;
+                    #endif
+                }
+                if (!visitor(ctx, values[i], lines[i])) return true;
+            }
+        }
+        return true;
+    }
+
+    JsonLinesWriter& JsonLinesWriter::write(const JsonValue& v) {
+        JsonSerializer::writeValue(out, v);
+        out.put('\n');
+        return *this;
+    }
+}
@@ -0,0 +1,209 @@
+#include "HMS_JSON_Number.h"
+
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#if !defined(__cpp_lib_to_chars) || __cpp_lib_to_chars < 201611L
+#include <clocale>
+#include <cstdio>
+#include <cstring>
+#define HMS_JSON_NO_FROM_CHARS 1
+#endif
+
+namespace HMS {
+    namespace detail {
+        namespace {
+            inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+            const char digitPairs[] =
+                "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                "8081828384858687888990919293949596979899";
+
+            const double exactPowersOfTen[] = {
+                1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+
+            // Correctly rounded conversion of an already validated number token.
+            bool slowPath(const char* first, const char* last, double& out) {
+                #if !HMS_JSON_NO_FROM_CHARS
+                    auto res = std::from_chars(first, last, out);
+                    return res.ec == std::errc();
+                #else
+                    // strtod is locale dependent, so the token is copied with the locale's radix character
+                    char local[64];
+                    std::string heap;
+                    size_t len = static_cast<size_t>(last - first);
+                    char* buf = local;
+                    if (len >= sizeof(local)) { heap.resize(len + 1); buf = &heap[0]; }
+                    std::memcpy(buf, first, len);
+                    buf[len] = '\0';
+                    const char* radix = std::localeconv()->decimal_point;
+                    if (radix && radix[0] != '.' && radix[0] != '\0') {
+                        if (char* dot = std::strchr(buf, '.')) *dot = radix[0];
+                    }
+                    char* end = nullptr;
+                    out = std::strtod(buf, &end);
+                    return std::isfinite(out) && (out != 0.0 || std::strpbrk(buf, "123456789") == nullptr);
+                #endif
+            }
+        }
+
+        NumberStatus parseNumber(const char*& p, const char* last, NumberValue& out) {
+            const char* first       = p;
+            bool        negative    = false;
+            bool        integral    = true;
+            uint64_t    mantissa    = 0;
+            int         digits      = 0;            // significant digits seen
+            int         kept        = 0;            // significant digits held in mantissa
+            long        exp10       = 0;
+
+            out.kind = NumberValue::Double;
+            if (p < last && *p == '-') { negative = true; ++p; }
+            if (p >= last || !isDigit(*p)) return NumberStatus::Invalid;
+
+            const char* intDigits = p;
+            if (*p == '0') {
+                ++p;
+            } else {
+                for (; p < last && isDigit(*p); ++p) {
+                    ++digits;
+                    if (kept < 19) { mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0'); ++kept; }
+                    else exp10++;
+                }
+            }
+
+            if (p < last && *p == '.') {
+                integral = false;
+                ++p;
+                if (p >= last || !isDigit(*p)) return NumberStatus::Invalid;
+                for (; p < last && isDigit(*p); ++p) {
+                    if (mantissa == 0 && *p == '0') { exp10--; continue; }       // leading zeros of 0.000x
+                    ++digits;
+                    if (kept < 19) { mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0'); ++kept; exp10--; }
+                }
+            }
+
+            if (p < last && (*p == 'e' || *p == 'E')) {
+                integral = false;
+                ++p;
+                bool expNegative = false;
+                if (p < last && (*p == '+' || *p == '-')) { expNegative = *p == '-'; ++p; }
+                if (p >= last || !isDigit(*p)) return NumberStatus::Invalid;
+                long e = 0;
+                for (; p < last && isDigit(*p); ++p) {
+                    if (e < 100000) e = e * 10 + (*p - '0');
+                }
+                exp10 += expNegative ? -e : e;
+            }
+
+            // -0 has no integer form and stays a double, a plain 0 is an ordinary Int64
+            if (integral && (mantissa != 0 || !negative)) {
+                if (digits == kept) {
+                    if (!negative) {
+                        if (mantissa <= static_cast<uint64_t>(INT64_MAX)) { out.kind = NumberValue::Int64; out.i = static_cast<int64_t>(mantissa); }
+                        else { out.kind = NumberValue::UInt64; out.u = mantissa; }
+                        return NumberStatus::Ok;
+                    }
+                    if (mantissa <= uint64_t(1) << 63) {
+                        out.kind = NumberValue::Int64;
+                        out.i = -static_cast<int64_t>(mantissa - 1) - 1;
+                        return NumberStatus::Ok;
+                    }
+                } else if (digits == 20 && !negative) {
+                    uint64_t u = 0;
+                    bool fits = true;
+                    for (const char* q = intDigits; q < p && fits; ++q) {
+                        unsigned d = static_cast<unsigned>(*q - '0');
+                        if (u > (UINT64_MAX - d) / 10) fits = false;
+                        else u = u * 10 + d;
+                    }
+                    if (fits) { out.kind = NumberValue::UInt64; out.u = u; return NumberStatus::Ok; }
+                }
+            }
+
+            if (mantissa == 0) {
+                out.d = negative ? -0.0 : 0.0;
+                return NumberStatus::Ok;
+            }
+
+            if (digits == kept) {
+                if (exp10 == 0) {
+                    double d = static_cast<double>(mantissa);
+                    out.d = negative ? -d : d;
+                    return NumberStatus::Ok;
+                }
+                if (mantissa <= (uint64_t(1) << 53) && exp10 >= -22 && exp10 <= 22) {
+                    double d = static_cast<double>(mantissa);
+                    d = exp10 < 0 ? d / exactPowersOfTen[-exp10] : d * exactPowersOfTen[exp10];
+                    out.d = negative ? -d : d;
+                    return NumberStatus::Ok;
+                }
+            }
+
+            if (slowPath(first, p, out.d)) return NumberStatus::Ok;
+            if (exp10 + digits <= 0) {                  // underflow, the nearest double is zero
+                out.d = negative ? -0.0 : 0.0;
+                return NumberStatus::Ok;
+            }
+            return NumberStatus::OutOfRange;
+        }
+
+        NumberStatus parseNumber(const char*& p, const char* last, double& out) {
+            NumberValue v;
+            NumberStatus status = parseNumber(p, last, v);
+            switch (v.kind) {
+                case NumberValue::Int64:    out = static_cast<double>(v.i);     break;
+                case NumberValue::UInt64:   out = static_cast<double>(v.u);     break;
+                default:                    out = v.d;                          break;
+            }
+            return status;
+        }
+
+        size_t formatDouble(char* buf, double d) {
+            #if !HMS_JSON_NO_FROM_CHARS
+                return static_cast<size_t>(std::to_chars(buf, buf + 32, d).ptr - buf);
+            #else
+                // Without std::to_chars: the shortest of %.15g, %.16g and %.17g that reads back exactly
+                const char* radix = std::localeconv()->decimal_point;
+                int n = 0;
+                for (int precision = 15; precision <= 17; ++precision) {
+                    n = std::snprintf(buf, 32, "%.*g", precision, d);
+                    if (radix && radix[0] != '.' && radix[0] != '\0') {
+                        if (char* r = static_cast<char*>(std::memchr(buf, radix[0], static_cast<size_t>(n)))) *r = '.';
+                    }
+                    const char* p = buf;
+                    double back;
+                    if (parseNumber(p, buf + n, back) == NumberStatus::Ok && back == d) break;
+                }
+                return static_cast<size_t>(n);
+            #endif
+        }
+
+        size_t formatInteger(char* buf, uint64_t v) {
+            char tmp[20];
+            size_t n = 0;
+            while (v >= 100) {
+                unsigned r = static_cast<unsigned>(v % 100);
+                v /= 100;
+                tmp[n++] = digitPairs[2 * r + 1];
+                tmp[n++] = digitPairs[2 * r];
+            }
+            if (v >= 10) {
+                tmp[n++] = digitPairs[2 * v + 1];
+                tmp[n++] = digitPairs[2 * v];
+            } else {
+                tmp[n++] = static_cast<char>('0' + v);
+            }
+            for (size_t i = 0; i < n; ++i) buf[i] = tmp[n - 1 - i];
+            return n;
+        }
+
+        size_t formatInteger(char* buf, int64_t v) {
+            if (v >= 0) return formatInteger(buf, static_cast<uint64_t>(v));
+            buf[0] = '-';
+            return 1 + formatInteger(buf + 1, static_cast<uint64_t>(0) - static_cast<uint64_t>(v));
+        }
+    }
+}
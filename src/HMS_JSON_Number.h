@@ -0,0 +1,47 @@
+#ifndef HMS_JSON_NUMBER_H
+#define HMS_JSON_NUMBER_H
+
+#include "HMS_JSON_Config.h"
+
+namespace HMS {
+    namespace detail {
+        enum class NumberStatus {
+            Ok,
+            Invalid,            // not a JSON number
+            OutOfRange          // magnitude too large for a double
+        };
+
+        struct NumberValue {
+            enum Kind : uint8_t { Double, Int64, UInt64 };
+
+            Kind        kind    = Double;
+            double      d       = 0.0;
+            int64_t     i       = 0;
+            uint64_t    u       = 0;
+        };
+
+        /*
+         * Parses the JSON number at p without copying it and independent of the C locale. Advances p
+         * past the number, or to the offending byte when it does not follow the JSON grammar. The
+         * result is the correctly rounded double: integers up to 19 digits and decimals with a 53 bit
+         * significand and a power of ten up to 22 take exact fast paths, everything else goes through
+         * std::from_chars where the standard library has it.
+         */
+        NumberStatus parseNumber(const char*& p, const char* last, double& out);
+
+        // Same, but literals without fraction or exponent that fit in 64 bits come back as integers:
+        // negative ones as Int64, positive ones as Int64 up to INT64_MAX and UInt64 above. -0 is the
+        // only integral literal that stays a Double, so its sign survives a round trip.
+        NumberStatus parseNumber(const char*& p, const char* last, NumberValue& out);
+
+        // Shortest text that parses back to exactly d; d must be finite. Needs 32 bytes of room and
+        // returns the number of chars written.
+        size_t formatDouble(char* buf, double d);
+
+        // Decimal text of an integer, returns the number of chars written (at most 20).
+        size_t formatInteger(char* buf, int64_t v);
+        size_t formatInteger(char* buf, uint64_t v);
+    }
+}
+
+#endif // HMS_JSON_NUMBER_H
@@ -0,0 +1,243 @@
+#include "HMS_JSON_Deserializer.h"
+#include "HMS_JSON_Arena.h"
+#include "HMS_JSON_Skip.h"
+#include "HMS_JSON_ThreadPool.h"
+
+#include <algorithm>
+
+namespace HMS {
+    namespace {
+        constexpr size_t MIN_RANGE_BYTES    = 64 * 1024;    // smaller ranges cost more in scheduling than they save
+        constexpr size_t RANGES_PER_THREAD  = 4;            // slack for ranges that parse slower than their size suggests
+        constexpr unsigned MAX_DESCENT      = 8;            // levels of single dominant members followed inwards
+
+        // Consecutive members or elements of the top level container parsed by one task.
+        struct Range {
+            size_t begin;       // first byte of the first member, the opening quote of its key in objects
+            size_t end;         // one past the last byte of the last member's value
+            size_t first;       // index of the first member
+            size_t count;
+        };
+
+        // The member with the largest value and the boundaries needed to parse around it.
+        struct Member {
+            size_t begin    = 0;    // first byte, the opening quote of its key in objects
+            size_t keyEnd   = 0;    // one past the closing quote of the key, objects only
+            size_t value    = 0;    // first byte of the value
+            size_t end      = 0;    // one past the last byte of the value
+            size_t index    = 0;
+            size_t prevEnd  = 0;    // end of the previous member's value, 0 for the first member
+            size_t nextBegin = 0;   // first byte of the next member, 0 for the last member
+        };
+
+        // Where the members of the container split() looked at start and end.
+        struct Members {
+            size_t  firstBegin  = 0;
+            size_t  lastEnd     = 0;
+            size_t  count       = 0;
+            Member  largest;
+        };
+
+        /*
+         * Finds the member boundaries of the top level container without parsing anything and
+         * groups them into ranges of about rangeBytes each. Every separator and the bytes after
+         * the closing bracket are checked here, the ranges then only hold complete members. false
+         * for anything this scan cannot vouch for, which the serial parser then has to look at.
+         */
+        bool split(std::string_view s, size_t rangeBytes, bool& object, std::vector<Range>& ranges, Members& m) {
+            size_t p = detail::skipSpace(s, 0);
+            if (p >= s.size() || (s[p] != '[' && s[p] != '{')) return false;
+            object          = s[p] == '{';
+            char close      = object ? '}' : ']';
+            const char* why = nullptr;
+            size_t& count   = m.count;
+            size_t prevEnd  = 0;
+            bool needNext   = false;
+            Range r{0, 0, 0, 0};
+            count           = 0;
+
+            p = detail::skipSpace(s, p + 1);
+            if (p < s.size() && s[p] == close) return false;
+            m.firstBegin = p;
+            while (true) {
+                if (p >= s.size()) return false;
+                size_t start    = p;
+                size_t keyEnd   = 0;
+                if (needNext) { m.largest.nextBegin = start; needNext = false; }
+                if (object) {
+                    if (s[p] != '"') return false;
+                    p = detail::skipString(s, p);
+                    if (p == detail::SKIP_FAILED) return false;
+                    keyEnd = p;
+                    p = detail::skipSpace(s, p);
+                    if (p >= s.size() || s[p] != ':') return false;
+                    p = detail::skipSpace(s, p + 1);
+                    if (p >= s.size()) return false;
+                }
+                size_t value = p;
+                p = detail::skipValue(s, p, why);
+                if (p == detail::SKIP_FAILED) return false;
+
+                if (count == 0 || p - value > m.largest.end - m.largest.value) {
+                    m.largest   = Member{start, keyEnd, value, p, count, prevEnd, 0};
+                    needNext    = true;
+                }
+                prevEnd = p;
+
+                if (r.count == 0) { r.begin = start; r.first = count; }
+                r.end = p;
+                r.count++;
+                count++;
+                if (r.end - r.begin >= rangeBytes) { ranges.push_back(r); r.count = 0; }
+
+                p = detail::skipSpace(s, p);
+                if (p >= s.size()) return false;
+                if (s[p] == close) break;
+                if (s[p] != ',') return false;
+                p = detail::skipSpace(s, p + 1);
+            }
+            m.lastEnd = prevEnd;
+            if (r.count) ranges.push_back(r);
+            return detail::skipSpace(s, p + 1) == s.size();
+        }
+    }
+
+    #if HMS_JSON_EXCEPTIONS_ENABLED
+        JsonValue JsonDeserializer::deserializeParallel(std::string_view src, unsigned threads) {
+            JsonValue v;
+            if (parseParallel(src, threads, v)) return v;
+            return deserialize(src);
+        }
+    #else
+        JsonValue JsonDeserializer::deserializeParallel(std::string_view src, ParseError& err_out, unsigned threads) {
+            err_out = ParseError{};
+            JsonValue v;
+            if (parseParallel(src, threads, v)) return v;
+            return deserialize(src, err_out);
+        }
+    #endif
+
+        /*
+         * Parses the members of a top level array or object range by range across the thread pool.
+         * When one member holds most of the document, as in {"records":[...]}, its value is split
+         * the same way instead and the members around it are parsed on the calling thread.
+         * Returns false without an error whenever it cannot produce the result itself: input too
+         * small, a scalar document, an arena scope on this thread (the tree has to end up in the
+         * arena, which is not shared with the workers) or anything malformed. The caller then
+         * parses serially, so errors always carry the position of the whole document.
+         */
+        bool JsonDeserializer::parseParallel(std::string_view src, unsigned threads, JsonValue& out, unsigned depth) {
+            if (threads == 0) threads = detail::defaultThreads();
+            if (threads <= 1 || src.size() < HMS_JSON_PARALLEL_MIN_SIZE || JsonArena::current()) return false;
+
+            size_t rangeBytes = std::max(MIN_RANGE_BYTES, src.size() / (threads * RANGES_PER_THREAD));
+            std::vector<Range> ranges;
+            bool object;
+            Members members;
+            if (!split(src, rangeBytes, object, ranges, members)) return false;
+            size_t count = members.count;
+
+            JsonArray               elements;
+            std::vector<JsonObject::key_type> keys;
+            std::vector<JsonValue>  values;
+            if (object) {
+                keys.resize(count);
+                values.resize(count);
+            } else {
+                elements.resize(count);
+            }
+            JsonObject::key_type* k = object ? keys.data() : nullptr;
+            JsonValue* v            = object ? values.data() : elements.data();
+
+            const Member& big = members.largest;
+            if (big.end - big.value > src.size() / 2) {
+                char open = src[big.value];
+                if (depth >= MAX_DESCENT || (open != '[' && open != '{')) return false;
+                if (!parseParallel(src.substr(big.value, big.end - big.value), threads, v[big.index], depth + 1)) return false;
+
+                size_t after = count - big.index - 1;
+                if (big.index && !parseMembers(src.substr(members.firstBegin, big.prevEnd - members.firstBegin), big.index, k, v)) return false;
+                if (after && !parseMembers(src.substr(big.nextBegin, members.lastEnd - big.nextBegin), after,
+                                           k ? k + big.index + 1 : nullptr, v + big.index + 1)) return false;
+                if (object && !parseMembers(src.substr(big.begin, big.keyEnd - big.begin), 1, k + big.index, nullptr)) return false;
+            } else {
+                if (ranges.size() < 2) return false;
+                std::vector<char> failed(ranges.size(), 0);
+                detail::parallelFor(ranges.size(), threads, [&](size_t t) {
+                    const Range& r = ranges[t];
+                    if (!parseMembers(src.substr(r.begin, r.end - r.begin), r.count, k ? k + r.first : nullptr, v + r.first)) failed[t] = 1;
+                });
+                if (std::find(failed.begin(), failed.end(), 1) != failed.end()) return false;
+            }
+
+            if (!object) {
+                out = JsonValue(std::move(elements));
+                return true;
+            }
+            // Inserted in document order so the first of duplicate keys wins, as in parseObject().
+            JsonObject obj;
+            for (size_t i = 0; i < count; ++i) obj.emplace(std::move(keys[i]), std::move(values[i]));
+            out = JsonValue(std::move(obj));
+            return true;
+        }
+
+        // parseRange() over a slice of the document, false instead of an error on malformed input.
+        bool JsonDeserializer::parseMembers(std::string_view slice, size_t count, JsonObject::key_type* keys, JsonValue* values) {
+            JsonDeserializer deser{slice};
+            #if HMS_JSON_EXCEPTIONS_ENABLED
+                try {
+                    return deser.parseRange(count, keys, values);
+                } catch (const ParseError&) {
+                    return false;
+                }
+            #else
+                ParseError e;
+                deser.err = &e;
+                return deser.parseRange(count, keys, values);
+            #endif
+        }
+
+        // The whole string is `count` comma separated members, with keys when keys is not null.
+        // Without values it is a single key on its own.
+        bool JsonDeserializer::parseRange(size_t count, JsonObject::key_type* keys, JsonValue* values) {
+            #ifdef HMS_JSON_INTERN_KEYS
+                detail::ParseKeyScope scope;                            // one table per task, the tables are not shared
+            #endif
+            std::vector<uint32_t> tokens;
+            prepare(tokens);
+            char c = nextToken();
+            if (!values) {
+                if (!parseKey(keys[0])) return false;
+                nextToken();
+            }
+            for (size_t i = 0; values && i < count; ++i) {
+                if (i) {
+                    if (c != ',') return error("Expected ','");
+                    pos++;
+                    c = nextToken();
+                }
+                if (keys) {
+                    if (!parseKey(keys[i])) return false;
+                    if (nextToken() != ':') return error("Expected ':'");
+                    pos++;
+                    nextToken();
+                }
+                if (!parseJsonValue(values[i])) return false;
+                c = nextToken();
+            }
+            if (pos != string.size()) return error("Trailing data after JSON");
+            return true;
+        }
+
+        bool JsonDeserializer::parseKey(JsonObject::key_type& key) {
+            if (pos >= string.size() || string[pos] != '"') return error("Object keys must be strings");
+            #ifdef HMS_JSON_INTERN_KEYS
+                std::string_view text;
+                if (!saxString(text)) return false;
+                key = JsonKey(text);
+                return true;
+            #else
+                return parseString(key);
+            #endif
+        }
+}
@@ -0,0 +1,59 @@
+#ifndef HMS_JSON_RECORDER_H
+#define HMS_JSON_RECORDER_H
+
+#include "HMS_JSON_Stats.h"
+
+#ifdef HMS_JSON_STATS
+#include <chrono>
+
+namespace HMS {
+    namespace detail {
+        /*
+         * Measures one instrumented operation on this thread. The counters keep running across
+         * operations, a recorder only reports how far they moved while it was alive. It publishes
+         * from its destructor so error returns and thrown ParseErrors are reported as failures.
+         */
+        class StatsRecorder {
+            public:
+                StatsRecorder(JsonStats::Operation op, size_t bytes);
+                ~StatsRecorder();
+
+                StatsRecorder(const StatsRecorder&)             = delete;
+                StatsRecorder& operator=(const StatsRecorder&)  = delete;
+
+                void indexed()                  { indexAt = std::chrono::steady_clock::now(); }
+                void succeeded(size_t bytes)    { stats.bytes = bytes; stats.failed = false; }
+
+            private:
+                using Clock = std::chrono::steady_clock;
+
+                JsonStats           stats;
+                StatsCounters       start;
+                size_t              outerMaxDepth;
+                Clock::time_point   startAt;
+                Clock::time_point   indexAt;
+        };
+
+        // One level of container nesting while alive.
+        class StatsDepth {
+            public:
+                StatsDepth() {
+                    StatsCounters& c = statsCounters;
+                    if (++c.depth > c.maxDepth) c.maxDepth = c.depth;
+                }
+                ~StatsDepth() { statsCounters.depth--; }
+
+                StatsDepth(const StatsDepth&)               = delete;
+                StatsDepth& operator=(const StatsDepth&)    = delete;
+        };
+
+        // Writers know their level already.
+        inline void statsReach(size_t depth) {
+            StatsCounters& c = statsCounters;
+            if (c.depth + depth > c.maxDepth) c.maxDepth = c.depth + depth;
+        }
+    }
+}
+#endif
+
+#endif // HMS_JSON_RECORDER_H
@@ -1,73 +1,191 @@
 #include "HMS_JSON_Serializer.h"
+#include "HMS_JSON_Number.h"
+#include "HMS_JSON_Recorder.h"
+#include "HMS_JSON_Strings.h"
+#include "HMS_JSON_ThreadPool.h"
+
+#include <algorithm>
 
 namespace HMS {
+    namespace {
+        constexpr size_t PARTS_PER_THREAD   = 4;        // slack for parts with heavier children than average
+        constexpr size_t MIN_PART_ELEMENTS  = 256;
+
+        // Children 0 .. count - 1 written by child(out, i), split into parts that are serialized
+        // into their own buffers concurrently and then appended to out in order.
+        void writeParallel(JsonOutput& out, size_t count, unsigned threads, const std::function<void(JsonOutput&, size_t)>& child) {
+            size_t parts = std::max<size_t>(1, std::min<size_t>(threads * PARTS_PER_THREAD, count / MIN_PART_ELEMENTS));
+            std::vector<std::string> buffers(parts);
+            detail::parallelFor(parts, threads, [&](size_t t) {
+                JsonStringSink sink(buffers[t]);
+                JsonOutput part(sink);
+                size_t last = count * (t + 1) / parts;
+                for (size_t i = count * t / parts; i < last; ++i) child(part, i);
+            });
+            for (const std::string& b : buffers) out.write(b.data(), b.size());
+        }
+    }
 
     std::string JsonSerializer::toString(const JsonValue& v, bool pretty, int indent) {
-        std::ostringstream oss;
-        serializeInternal(v, oss, pretty, indent, 0);
-        return oss.str();
+        std::string out;
+        serializeTo(v, out, pretty, indent);
+        return out;
+    }
+
+    void JsonSerializer::serializeTo(const JsonValue& v, std::string& out, bool pretty, int indent) {
+        out.clear();
+        JsonStringSink sink(out);
+        serialize(v, sink, pretty, indent);
+    }
+
+    void JsonSerializer::serializeTo(const JsonValue& v, std::vector<char>& out, bool pretty, int indent) {
+        out.clear();
+        JsonVectorSink sink(out);
+        serialize(v, sink, pretty, indent);
     }
 
-    void JsonSerializer::serialize(const JsonValue& v, std::ostream& out, bool pretty, int indent) {
+    void JsonSerializer::serialize(const JsonValue& v, JsonSink& sink, bool pretty, int indent) {
+        #ifdef HMS_JSON_STATS
+            detail::StatsRecorder stats(JsonStats::Serialize, 0);
+        #endif
+        JsonOutput out(sink);
         serializeInternal(v, out, pretty, indent, 0);
+        #ifdef HMS_JSON_STATS
+            out.flush();
+            stats.succeeded(out.bytes());
+        #endif
     }
 
-    std::string JsonSerializer::escape(const std::string& s) {
-        std::string out; out.reserve(s.size());
-        for (char c : s) {
-            switch (c) {
-                case '\"': out += "\\\""; break;
-                case '\\': out += "\\\\"; break;
-                case '\b': out += "\\b"; break;
-                case '\f': out += "\\f"; break;
-                case '\n': out += "\\n"; break;
-                case '\r': out += "\\r"; break;
-                case '\t': out += "\\t"; break;
-                default: out.push_back(c); break;
-            }
+    size_t JsonSerializer::measure(const JsonValue& v, bool pretty, int indent) {
+        JsonCountingSink sink;
+        serialize(v, sink, pretty, indent);
+        return sink.size();
+    }
+
+    size_t JsonSerializer::serializeInto(const JsonValue& v, char* buf, size_t cap, bool pretty, int indent) {
+        JsonFixedBufferSink sink(buf, cap);
+        serialize(v, sink, pretty, indent);
+        return sink.size();
+    }
+
+    #ifndef HMS_JSON_NO_IOSTREAM
+        void JsonSerializer::serialize(const JsonValue& v, std::ostream& out, bool pretty, int indent) {
+            JsonStreamSink sink(out);
+            serialize(v, sink, pretty, indent);
         }
+    #endif
+
+    void JsonSerializer::serializeParallel(const JsonValue& v, JsonSink& sink, bool pretty, int indent, unsigned threads) {
+        JsonOutput out(sink);
+        serializeInternal(v, out, pretty, indent, 0, threads ? threads : detail::defaultThreads());
+    }
+
+    std::string JsonSerializer::toStringParallel(const JsonValue& v, bool pretty, int indent, unsigned threads) {
+        std::string out;
+        JsonStringSink sink(out);
+        serializeParallel(v, sink, pretty, indent, threads);
         return out;
     }
 
-    void JsonSerializer::serializeInternal(const JsonValue& v, std::ostream& out, bool pretty, int indent, int level) {
-        if (v.isNull()) { out << "null"; return; }
-        if (v.isBool()) { out << (v.asBool() ? "true" : "false"); return; }
-        if (v.isNumber()) {
-            double d = v.asNumber();
-            if (std::isfinite(d)) out << d;
-            else out << "null";
-            return;
+    void JsonSerializer::writeString(JsonOutput& out, std::string_view s) {
+        static const char hex[] = "0123456789abcdef";
+        out.put('"');
+        const char* p   = s.data();
+        const char* end = p + s.size();
+        while (p < end) {
+            const char* run = p;
+            p = detail::scanEscapes(p, end);
+            out.write(run, static_cast<size_t>(p - run));
+            if (p == end) break;
+            char c = *p++;
+            switch (c) {
+                case '\"': out.write("\\\"", 2); break;
+                case '\\': out.write("\\\\", 2); break;
+                case '\b': out.write("\\b", 2); break;
+                case '\f': out.write("\\f", 2); break;
+                case '\n': out.write("\\n", 2); break;
+                case '\r': out.write("\\r", 2); break;
+                case '\t': out.write("\\t", 2); break;
+                default: {
+                    char u[6] = { '\\', 'u', '0', '0', hex[(c >> 4) & 0xF], hex[c & 0xF] };
+                    out.write(u, 6);
+                } break;
+            }
         }
+        out.put('"');
+    }
+
+    void JsonSerializer::writeDouble(JsonOutput& out, double d) {
+        if (!std::isfinite(d)) { out.write("null", 4); return; }
+        out.commit(detail::formatDouble(out.reserve(32), d));
+    }
+
+    void JsonSerializer::writeInteger(JsonOutput& out, int64_t i) {
+        out.commit(detail::formatInteger(out.reserve(24), i));
+    }
+
+    void JsonSerializer::writeInteger(JsonOutput& out, uint64_t u) {
+        out.commit(detail::formatInteger(out.reserve(24), u));
+    }
+
+    void JsonSerializer::writeValue(JsonOutput& out, const JsonValue& v, bool pretty, int indent, int level) {
+        serializeInternal(v, out, pretty, indent, level);
+    }
+
+    void JsonSerializer::serializeInternal(const JsonValue& v, JsonOutput& out, bool pretty, int indent, int level, unsigned threads) {
+        HMS_JSON_STATS_ADD(nodes, 1);
+        if (v.isNull()) { out.write("null", 4); return; }
+        if (v.isBool()) { v.asBool() ? out.write("true", 4) : out.write("false", 5); return; }
+        if (auto i = v.getIf<int64_t>())  { writeInteger(out, *i); return; }
+        if (auto u = v.getIf<uint64_t>()) { writeInteger(out, *u); return; }
+        if (v.isNumber()) { writeDouble(out, v.asNumber()); return; }
 
-        if (v.isString()) { out << '\"' << escape(v.asString()) << '\"'; return; }
+        if (v.isString()) { writeString(out, v.asString()); return; }
 
+        #ifdef HMS_JSON_STATS
+            if (v.isArray() || v.isObject()) detail::statsReach(static_cast<size_t>(level) + 1);
+        #endif
         if (v.isArray()) {
             const auto &a = v.asArray();
-            out << '[';
-            if (pretty && !a.empty()) out << '\n';
-            for (size_t i=0;i<a.size();++i) {
-                if (pretty) out << std::string(static_cast<size_t>((level+1)*indent), ' ');
-                serializeInternal(a[i], out, pretty, indent, level+1);
-                if (i+1 < a.size()) out << (pretty ? ",\n" : ",");
+            auto element = [&](JsonOutput& o, size_t i, unsigned t) {
+                if (pretty) o.fill(' ', static_cast<size_t>((level+1)*indent));
+                serializeInternal(a[i], o, pretty, indent, level+1, t);
+                if (i+1 < a.size()) pretty ? o.write(",\n", 2) : o.put(',');
+            };
+            out.put('[');
+            if (pretty && !a.empty()) out.put('\n');
+            if (threads > 1 && a.size() >= HMS_JSON_PARALLEL_MIN_ELEMENTS) {
+                writeParallel(out, a.size(), threads, [&](JsonOutput& o, size_t i) { element(o, i, 1); });
+            } else {
+                for (size_t i=0;i<a.size();++i) element(out, i, threads);
             }
-            if (pretty && !a.empty()) out << '\n' << std::string(static_cast<size_t>(level*indent), ' ');
-            out << ']';
+            if (pretty && !a.empty()) { out.put('\n'); out.fill(' ', static_cast<size_t>(level*indent)); }
+            out.put(']');
             return;
         }
 
         if (v.isObject()) {
             const auto &o = v.asObject();
-            out << '{';
-            if (pretty && !o.empty()) out << '\n';
-            size_t idx=0;
-            for (auto &kv : o) {
-                if (pretty) out << std::string(static_cast<size_t>((level+1)*indent), ' ');
-                out << '\"' << escape(kv.first) << '\"' << (pretty ? ": " : ":");
-                serializeInternal(kv.second, out, pretty, indent, level+1);
-                if (++idx < o.size()) out << (pretty ? ",\n" : ",");
+            auto member = [&](JsonOutput& w, const JsonObject::value_type& kv, bool last, unsigned t) {
+                if (pretty) w.fill(' ', static_cast<size_t>((level+1)*indent));
+                writeString(w, kv.first);
+                pretty ? w.write(": ", 2) : w.put(':');
+                serializeInternal(kv.second, w, pretty, indent, level+1, t);
+                if (!last) pretty ? w.write(",\n", 2) : w.put(',');
+            };
+            out.put('{');
+            if (pretty && !o.empty()) out.put('\n');
+            if (threads > 1 && o.size() >= HMS_JSON_PARALLEL_MIN_ELEMENTS) {
+                std::vector<const JsonObject::value_type*> members;
+                members.reserve(o.size());
+                for (auto &kv : o) members.push_back(&kv);
+                writeParallel(out, members.size(), threads, [&](JsonOutput& w, size_t i) { member(w, *members[i], i+1 == members.size(), 1); });
+            } else {
+                size_t idx=0;
+                for (auto &kv : o) member(out, kv, ++idx == o.size(), threads);
             }
-            if (pretty && !o.empty()) out << '\n' << std::string(static_cast<size_t>(level*indent), ' ');
-            out << '}';
+            if (pretty && !o.empty()) { out.put('\n'); out.fill(' ', static_cast<size_t>(level*indent)); }
+            out.put('}');
             return;
         }
     }
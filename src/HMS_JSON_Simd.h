@@ -0,0 +1,63 @@
+#ifndef HMS_JSON_SIMD_H
+#define HMS_JSON_SIMD_H
+
+#include "HMS_JSON_Config.h"
+
+/*
+ * Vector kernels are only built for x86-64 desktop targets. SSE2 is part of the x86-64 baseline,
+ * AVX2 kernels are compiled with a target attribute and picked at runtime. Every other target
+ * (ESP32, STM32, ...) uses the scalar code paths. Define HMS_JSON_NO_SIMD to force scalar code,
+ * HMS_JSON_NO_AVX2 to stay on the SSE2 kernels.
+ */
+#if !defined(HMS_JSON_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+    #define HMS_JSON_SIMD_SSE2 1
+    #include <emmintrin.h>
+    #if (defined(__GNUC__) || defined(__clang__)) && !defined(HMS_JSON_NO_AVX2)
+        #define HMS_JSON_SIMD_AVX2 1
+        #define HMS_JSON_TARGET_AVX2 __attribute__((target("avx2")))
+        #include <immintrin.h>
+    #endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define HMS_JSON_LIKELY(x)      __builtin_expect(!!(x), 1)
+    #define HMS_JSON_UNLIKELY(x)    __builtin_expect(!!(x), 0)
+#else
+    #define HMS_JSON_LIKELY(x)      (x)
+    #define HMS_JSON_UNLIKELY(x)    (x)
+#endif
+
+namespace HMS {
+    namespace detail {
+        inline unsigned countTrailingZeros(uint64_t v) {
+            #if defined(__GNUC__) || defined(__clang__)
+                return static_cast<unsigned>(__builtin_ctzll(v));
+            #else
+                unsigned n = 0;
+                while (!(v & 1)) { v >>= 1; ++n; }
+                return n;
+            #endif
+        }
+
+        inline unsigned popCount(uint64_t v) {
+            #if defined(__GNUC__) || defined(__clang__)
+                return static_cast<unsigned>(__builtin_popcountll(v));
+            #else
+                unsigned n = 0;
+                while (v) { v &= v - 1; ++n; }
+                return n;
+            #endif
+        }
+
+        inline bool cpuHasAvx2() {
+            #if HMS_JSON_SIMD_AVX2
+                static const bool avx2 = __builtin_cpu_supports("avx2");
+                return avx2;
+            #else
+                return false;
+            #endif
+        }
+    }
+}
+
+#endif // HMS_JSON_SIMD_H
@@ -0,0 +1,83 @@
+#ifndef HMS_JSON_SKIP_H
+#define HMS_JSON_SKIP_H
+
+#include "HMS_JSON_Strings.h"
+
+namespace HMS {
+    namespace detail {
+        /*
+         * Fast forward scanning over JSON text without parsing it, used to find value boundaries.
+         * Strings are skipped as a whole and containers by bracket depth only, so the skipped text
+         * still has to go through the parser before it can be trusted.
+         */
+        constexpr size_t SKIP_FAILED = static_cast<size_t>(-1);
+
+        inline bool isJsonSpace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+        inline bool isDelimiter(char c) {
+            return isJsonSpace(c) || c == ',' || c == ']' || c == '}' || c == ':' || c == '"' || c == '[' || c == '{';
+        }
+
+        inline size_t skipSpace(std::string_view s, size_t p) {
+            while (p < s.size() && isJsonSpace(s[p])) p++;
+            return p;
+        }
+
+        // Offset just past the closing quote of the string opening at p, SKIP_FAILED when it never closes.
+        inline size_t skipString(std::string_view s, size_t p) {
+            const char* begin   = s.data();
+            const char* end     = begin + s.size();
+            const char* q       = begin + p + 1;
+            while (true) {
+                q = detail::scanStringLiteral(q, end, false);
+                if (q >= end) return SKIP_FAILED;
+                if (*q == '"') return static_cast<size_t>(q - begin) + 1;
+                if (end - q < 2) return SKIP_FAILED;
+                q += 2;                                         // backslash and the escaped character
+            }
+        }
+
+        // Only depth is tracked, the full parser checks that the bracket kinds match if the
+        // subtree is ever materialized.
+        inline size_t skipContainer(std::string_view s, size_t p) {
+            const char* begin   = s.data();
+            const char* end     = begin + s.size();
+            const char* q       = begin + p;
+            size_t depth        = 0;
+            while (true) {
+                q = detail::scanBrackets(q, end);
+                if (q >= end) return SKIP_FAILED;
+                char c = *q;
+                if (c == '"') {
+                    size_t next = skipString(s, static_cast<size_t>(q - begin));
+                    if (next == SKIP_FAILED) return SKIP_FAILED;
+                    q = begin + next;
+                    continue;
+                }
+                if (c == '{' || c == '[') depth++;
+                else if (--depth == 0) return static_cast<size_t>(q - begin) + 1;
+                q++;
+            }
+        }
+
+        inline size_t skipValue(std::string_view s, size_t p, const char*& why) {
+            char c = s[p];
+            if (c == '"') {
+                why = "Unterminated string";
+                return skipString(s, p);
+            }
+            if (c == '{' || c == '[') {
+                why = "Unexpected end of input";
+                return skipContainer(s, p);
+            }
+            if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n') {
+                while (p < s.size() && !isDelimiter(s[p])) p++;
+                return p;
+            }
+            why = "Unexpected character";
+            return SKIP_FAILED;
+        }
+    }
+}
+
+#endif // HMS_JSON_SKIP_H
@@ -0,0 +1,81 @@
+#include "HMS_JSON_Recorder.h"
+
+#ifdef HMS_JSON_STATS
+#include <atomic>
+#ifndef HMS_JSON_NO_THREADS
+#include <mutex>
+#endif
+
+namespace HMS {
+    namespace {
+        thread_local JsonStats          lastStats;
+
+        // The callback and its user pointer change together under the mutex; hasCallback keeps
+        // the lock off the path of every operation while nothing is registered.
+        struct Registration {
+            JsonStats::Callback         callback    = nullptr;
+            void*                       user        = nullptr;
+        };
+        Registration                    registration;
+        std::atomic<bool>               hasCallback{false};
+        #ifndef HMS_JSON_NO_THREADS
+            std::mutex                  registrationMutex;
+        #endif
+
+        Registration currentRegistration() {
+            #ifndef HMS_JSON_NO_THREADS
+                std::lock_guard<std::mutex> lock(registrationMutex);
+            #endif
+            return registration;
+        }
+
+        uint64_t nanos(std::chrono::steady_clock::duration d) {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+        }
+    }
+
+    const JsonStats& JsonStats::last() {
+        return lastStats;
+    }
+
+    void JsonStats::setCallback(Callback cb, void* user) {
+        #ifndef HMS_JSON_NO_THREADS
+            std::lock_guard<std::mutex> lock(registrationMutex);
+        #endif
+        registration = Registration{cb, user};
+        hasCallback.store(cb != nullptr, std::memory_order_release);
+    }
+
+    namespace detail {
+        StatsRecorder::StatsRecorder(JsonStats::Operation op, size_t bytes) : start(statsCounters) {
+            StatsCounters& c    = statsCounters;
+            outerMaxDepth       = c.maxDepth;
+            c.maxDepth          = c.depth;
+            stats.operation     = op;
+            stats.bytes         = bytes;
+            stats.failed        = true;
+            startAt             = Clock::now();
+            indexAt             = startAt;
+        }
+
+        StatsRecorder::~StatsRecorder() {
+            Clock::time_point end = Clock::now();
+            StatsCounters& c        = statsCounters;
+            stats.nodes             = c.nodes - start.nodes;
+            stats.allocations       = c.allocations - start.allocations;
+            stats.allocatedBytes    = c.allocatedBytes - start.allocatedBytes;
+            stats.maxDepth          = c.maxDepth - start.depth;
+            stats.indexNanos        = nanos(indexAt - startAt);
+            stats.valueNanos        = nanos(end - indexAt);
+            stats.totalNanos        = nanos(end - startAt);
+            if (outerMaxDepth > c.maxDepth) c.maxDepth = outerMaxDepth;
+
+            lastStats = stats;
+            if (hasCallback.load(std::memory_order_acquire)) {
+                Registration r = currentRegistration();
+                if (r.callback) r.callback(stats, r.user);
+            }
+        }
+    }
+}
+#endif
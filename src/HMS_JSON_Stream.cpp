@@ -0,0 +1,371 @@
+#include "HMS_JSON_Stream.h"
+#include "HMS_JSON_Deserializer.h"
+#include "HMS_JSON_Number.h"
+#include "HMS_JSON_Skip.h"
+#include "HMS_JSON_Strings.h"
+
+namespace HMS {
+    namespace {
+        using detail::isJsonSpace;
+        using detail::isDelimiter;
+
+        inline bool isNumberChar(char c) {
+            return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+        }
+    }
+
+    void JsonDomBuilder::reset() {
+        root = JsonValue{};
+        stack.clear();
+        key.clear();
+        skipDepth = 0;
+        #ifdef HMS_JSON_INTERN_KEYS
+            keys.clear();
+        #endif
+    }
+
+    // Where the next value goes, nullptr while a duplicate key is being skipped.
+    JsonValue* JsonDomBuilder::slot() {
+        if (skipDepth) return nullptr;
+        if (stack.empty()) return &root;
+        JsonValue* top = stack.back();
+        if (auto a = top->getIf<JsonArray>()) {
+            a->emplace_back();
+            return &a->back();
+        }
+        #ifdef HMS_JSON_INTERN_KEYS
+            auto r = top->getIf<JsonObject>()->emplace(keys.intern(key), JsonValue{});
+        #else
+            auto r = top->getIf<JsonObject>()->emplace(std::move(key), JsonValue{});
+        #endif
+        return r.second ? &r.first->second : nullptr;
+    }
+
+    bool JsonDomBuilder::put(JsonValue&& v) {
+        if (JsonValue* s = slot()) *s = std::move(v);
+        return true;
+    }
+
+    bool JsonDomBuilder::open(JsonValue&& container) {
+        if (skipDepth) { skipDepth++; return true; }
+        JsonValue* s = slot();
+        if (!s) { skipDepth = 1; return true; }
+        *s = std::move(container);
+        stack.push_back(s);
+        return true;
+    }
+
+    bool JsonDomBuilder::close() {
+        if (skipDepth) { skipDepth--; return true; }
+        stack.pop_back();
+        return true;
+    }
+
+    void JsonStreamParser::reset() {
+        builder.reset();
+        state           = Value;
+        stack.clear();
+        raw.clear();
+        literal         = nullptr;
+        literalAt       = 0;
+        escapeBytes     = 0;
+        checkDelimiter  = false;
+        base            = 0;
+        lineStart       = 0;
+        line            = 1;
+        failMsg.clear();
+    }
+
+    #if HMS_JSON_EXCEPTIONS_ENABLED
+        void JsonStreamParser::feed(const char* data, size_t len) {
+            if (state == Failed) failed();
+            consume(data, len);
+        }
+
+        void JsonStreamParser::finish() {
+            if (state == Failed) failed();
+            end();
+        }
+
+        bool JsonStreamParser::fail(const std::string& msg, ErrorPos at) {
+            state   = Failed;
+            failMsg = msg;
+            failPos = at;
+            throw ParseError(msg, at);
+        }
+
+        bool JsonStreamParser::failed() {
+            throw ParseError(failMsg, failPos);
+        }
+    #else
+        bool JsonStreamParser::feed(const char* data, size_t len, ParseError& err_out) {
+            err_out = ParseError{};
+            err     = &err_out;
+            if (state == Failed) return failed();
+            return consume(data, len);
+        }
+
+        bool JsonStreamParser::finish(ParseError& err_out) {
+            err_out = ParseError{};
+            err     = &err_out;
+            if (state == Failed) return failed();
+            return end();
+        }
+
+        bool JsonStreamParser::fail(const std::string& msg, ErrorPos at) {
+            state   = Failed;
+            failMsg = msg;
+            failPos = at;
+            return failed();
+        }
+
+        bool JsonStreamParser::failed() {
+            *err = ParseError(failMsg, failPos);
+            return false;
+        }
+    #endif
+
+    bool JsonStreamParser::accepted(bool ok, ErrorPos at) {
+        return ok || fail("Parsing stopped by handler", at);
+    }
+
+    // rel is a position inside the current token text, which starts at tokenStart.
+    ErrorPos JsonStreamParser::inToken(ErrorPos rel) const {
+        if (rel.line == 1) return ErrorPos{tokenLine, static_cast<int>(tokenStart - tokenLineStart) + rel.col};
+        return ErrorPos{tokenLine + rel.line - 1, rel.col};
+    }
+
+    // Text of the token ending at to; only a token that began in an earlier chunk is copied.
+    std::string_view JsonStreamParser::token(const char* data, size_t from, size_t to) {
+        if (raw.empty()) return std::string_view(data + from, to - from);
+        raw.append(data + from, to - from);
+        return raw;
+    }
+
+    bool JsonStreamParser::consume(const char* data, size_t len) {
+        size_t i        = 0;
+        size_t begin    = 0;            // start of the current token within this chunk
+        while (i < len) {
+            char c = data[i];
+            switch (state) {
+                case InString: {
+                    if (escapeBytes) {
+                        // the escaped character and the four digits of \u are never a closing quote
+                        if (escapeBytes == ESCAPE_START) escapeBytes = c == 'u' ? 4 : 0;
+                        else escapeBytes--;
+                        if (c == '\n') { line++; lineStart = base + i + 1; }
+                        i++;
+                        continue;
+                    }
+                    i = static_cast<size_t>(detail::scanEscapes(data + i, data + len) - data);
+                    if (i >= len) continue;
+                    c = data[i++];
+                    if (c == '\\') { escapeBytes = ESCAPE_START; continue; }
+                    if (c == '\n') { line++; lineStart = base + i; }
+                    if (c != '"') continue;
+                    bool key = stringIsKey;
+                    if (!emitString(token(data, begin, i))) return false;
+                    raw.clear();
+                    if (key) state = Colon;
+                    else afterValue();
+                    continue;
+                }
+                case InNumber:
+                    if (isNumberChar(c)) { i++; continue; }
+                    if (!emitNumber(token(data, begin, i))) return false;
+                    raw.clear();
+                    continue;                                   // c is looked at again below
+                case InLiteral:
+                    if (c != literal[literalAt]) {
+                        return fail(literal[0] == 'n' ? "Invalid token, expected 'null'" : "Invalid token, expected 'true' or 'false'",
+                                    inToken(ErrorPos{}));
+                    }
+                    i++;
+                    if (literal[++literalAt] == '\0') {
+                        bool ok = literal[0] == 'n' ? handler->onNull() : handler->onBool(literal[0] == 't');
+                        if (!accepted(ok, inToken(ErrorPos{}))) return false;
+                        afterValue();
+                        checkDelimiter = true;
+                    }
+                    continue;
+                default:
+                    break;
+            }
+
+            if (checkDelimiter) {
+                checkDelimiter = false;
+                if (!isDelimiter(c)) return fail(std::string("Unexpected character '") + c + "'", here(i));
+            }
+            if (isJsonSpace(c)) {
+                if (c == '\n') { line++; lineStart = base + i + 1; }
+                i++;
+                continue;
+            }
+
+            switch (state) {
+                case ArrayFirst:
+                    if (c == ']') { if (!closeContainer(i)) return false; i++; continue; }
+                    // fall through
+                case Value:
+                    if (!startValue(c, i)) return false;
+                    begin = i++;
+                    continue;
+                case ObjectFirst:
+                    if (c == '}') { if (!closeContainer(i)) return false; i++; continue; }
+                    // fall through
+                case Key:
+                    if (c != '"') return fail("Object keys must be strings", here(i));
+                    beginToken(i);
+                    stringIsKey = true;
+                    state       = InString;
+                    begin       = i++;
+                    continue;
+                case Colon:
+                    if (c != ':') return fail("Expected ':'", here(i));
+                    state = Value;
+                    i++;
+                    continue;
+                case AfterValue: {
+                    bool inObject = stack.back() == '{';
+                    if (c == ',') { state = inObject ? Key : Value; i++; continue; }
+                    if (c == (inObject ? '}' : ']')) { if (!closeContainer(i)) return false; i++; continue; }
+                    return fail(inObject ? "Expected ',' or '}' in object" : "Expected ',' or ']' in array", here(i));
+                }
+                case Done:
+                    return fail("Trailing data after JSON", here(i));
+                default:
+                    return fail("Invalid parser state", here(i));
+            }
+        }
+
+        if (state == InString || state == InNumber) raw.append(data + begin, len - begin);
+        base += len;
+        return true;
+    }
+
+    bool JsonStreamParser::startValue(char c, size_t at) {
+        beginToken(at);
+        switch (c) {
+            case '"':
+                stringIsKey = false;
+                state       = InString;
+                return true;
+            case '{':
+                stack.push_back('{');
+                state = ObjectFirst;
+                return accepted(handler->onStartObject(), here(at));
+            case '[':
+                stack.push_back('[');
+                state = ArrayFirst;
+                return accepted(handler->onStartArray(), here(at));
+            case 't': literal = "true";  break;
+            case 'f': literal = "false"; break;
+            case 'n': literal = "null";  break;
+            default:
+                if (c == '-' || (c >= '0' && c <= '9')) {
+                    state = InNumber;
+                    return true;
+                }
+                return fail(std::string("Unexpected character '") + c + "'", here(at));
+        }
+        literalAt   = 1;
+        state       = InLiteral;
+        return true;
+    }
+
+    bool JsonStreamParser::closeContainer(size_t at) {
+        char open = stack.back();
+        stack.pop_back();
+        afterValue();
+        return accepted(open == '{' ? handler->onEndObject() : handler->onEndArray(), here(at));
+    }
+
+    // text includes both quotes. Literals without escapes or multi byte characters are passed
+    // through as they are, the rest goes through the regular string decoder.
+    bool JsonStreamParser::emitString(std::string_view text) {
+        const char* first   = text.data() + 1;
+        const char* last    = text.data() + text.size() - 1;
+        std::string_view s;
+        if (detail::scanStringLiteral(first, last, true) == last) {
+            s = std::string_view(first, static_cast<size_t>(last - first));
+        } else {
+            if (!decode(text)) return false;
+            s = scratch;
+        }
+        return accepted(stringIsKey ? handler->onKey(s) : handler->onString(s), inToken(ErrorPos{}));
+    }
+
+    bool JsonStreamParser::decode(std::string_view text) {
+        JsonDeserializer deser{text};
+        scratch.clear();
+        #if HMS_JSON_EXCEPTIONS_ENABLED
+            try {
+                return deser.parseString(scratch);
+            } catch (const ParseError& e) {
+                return fail(e.what(), inToken(e.pos));
+            }
+        #else
+            ParseError decodeErr;
+            deser.err = &decodeErr;
+            return deser.parseString(scratch) || fail(decodeErr.what, inToken(decodeErr.pos));
+        #endif
+    }
+
+    bool JsonStreamParser::emitNumber(std::string_view text) {
+        const char* p   = text.data();
+        const char* end = p + text.size();
+        detail::NumberValue n;
+        detail::NumberStatus status = detail::parseNumber(p, end, n);
+        ErrorPos stop   = inToken(ErrorPos{1, static_cast<int>(p - text.data()) + 1});
+        if (status == detail::NumberStatus::Invalid)    return fail("Invalid number format", stop);
+        if (status == detail::NumberStatus::OutOfRange) return fail("Number out of range", stop);
+        if (p != end) return fail(std::string("Unexpected character '") + *p + "'", stop);
+
+        bool ok;
+        switch (n.kind) {
+            case detail::NumberValue::Int64:    ok = handler->onInteger(n.i);   break;
+            case detail::NumberValue::UInt64:   ok = handler->onUnsigned(n.u);  break;
+            default:                            ok = handler->onNumber(n.d);    break;
+        }
+        if (!accepted(ok, inToken(ErrorPos{}))) return false;
+        afterValue();
+        checkDelimiter = true;
+        return true;
+    }
+
+    // End of input: flush a trailing number and report what the byte parser would report at
+    // the same offset.
+    bool JsonStreamParser::end() {
+        ErrorPos eof{line, static_cast<int>(base - lineStart) + 1};
+        switch (state) {
+            case InString: {
+                // Decoding what was buffered reports a bad escape before the missing quote, in
+                // document order like the byte parser.
+                std::string text;
+                text.swap(raw);
+                if (!decode(text)) return false;
+                return fail("Unterminated string", eof);
+            }
+            case InNumber: {
+                std::string text;
+                text.swap(raw);
+                if (!emitNumber(text)) return false;
+                break;
+            }
+            case InLiteral:
+                return fail(literal[0] == 'n' ? "Invalid token, expected 'null'" : "Invalid token, expected 'true' or 'false'", inToken(ErrorPos{}));
+            default:
+                break;
+        }
+        checkDelimiter = false;
+
+        switch (state) {
+            case Done:          return true;
+            case ObjectFirst:
+            case Key:           return fail("Object keys must be strings", eof);
+            case Colon:         return fail("Expected ':'", eof);
+            case AfterValue:    return fail(stack.back() == '{' ? "Expected ',' or '}' in object" : "Expected ',' or ']' in array", eof);
+            default:            return fail("Unexpected end of input", eof);
+        }
+    }
+}
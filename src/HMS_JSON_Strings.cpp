@@ -0,0 +1,168 @@
+#include "HMS_JSON_Strings.h"
+#include "HMS_JSON_Simd.h"
+
+namespace HMS {
+    namespace detail {
+        namespace {
+            inline bool isLiteralStop(char c, bool stopOnNonAscii) {
+                return c == '"' || c == '\\' || (stopOnNonAscii && (c & 0x80));
+            }
+
+            inline bool isEscapeStop(char c) {
+                return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+            }
+
+            inline bool isBracketStop(char c) {
+                return c == '"' || c == '[' || c == ']' || c == '{' || c == '}';
+            }
+
+            const char* scanLiteralScalar(const char* p, const char* end, bool stopOnNonAscii) {
+                while (p < end && !isLiteralStop(*p, stopOnNonAscii)) p++;
+                return p;
+            }
+
+            const char* scanEscapesScalar(const char* p, const char* end) {
+                while (p < end && !isEscapeStop(*p)) p++;
+                return p;
+            }
+
+            const char* scanBracketsScalar(const char* p, const char* end) {
+                while (p < end && !isBracketStop(*p)) p++;
+                return p;
+            }
+
+            #if HMS_JSON_SIMD_SSE2
+                const char* scanLiteralSse2(const char* p, const char* end, bool stopOnNonAscii) {
+                    const __m128i quote = _mm_set1_epi8('"');
+                    const __m128i slash = _mm_set1_epi8('\\');
+                    const int highMask  = stopOnNonAscii ? 0xFFFF : 0;
+                    for (; end - p >= 16; p += 16) {
+                        __m128i v   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                        int mask    = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash)))
+                                    | (_mm_movemask_epi8(v) & highMask);
+                        if (mask) return p + countTrailingZeros(static_cast<uint64_t>(mask));
+                    }
+                    return scanLiteralScalar(p, end, stopOnNonAscii);
+                }
+
+                const char* scanEscapesSse2(const char* p, const char* end) {
+                    const __m128i quote = _mm_set1_epi8('"');
+                    const __m128i slash = _mm_set1_epi8('\\');
+                    const __m128i ctrl  = _mm_set1_epi8(0x1F);
+                    const __m128i zero  = _mm_setzero_si128();
+                    for (; end - p >= 16; p += 16) {
+                        __m128i v   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                        __m128i low = _mm_cmpeq_epi8(_mm_subs_epu8(v, ctrl), zero);         // v <= 0x1F
+                        int mask    = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash)), low));
+                        if (mask) return p + countTrailingZeros(static_cast<uint64_t>(mask));
+                    }
+                    return scanEscapesScalar(p, end);
+                }
+
+                // '[' and ']' differ from '{' and '}' only in bit 0x20, so two compares cover all four.
+                const char* scanBracketsSse2(const char* p, const char* end) {
+                    const __m128i quote = _mm_set1_epi8('"');
+                    const __m128i bit   = _mm_set1_epi8(0x20);
+                    const __m128i open  = _mm_set1_epi8('{');
+                    const __m128i close = _mm_set1_epi8('}');
+                    for (; end - p >= 16; p += 16) {
+                        __m128i v   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                        __m128i f   = _mm_or_si128(v, bit);
+                        int mask    = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_or_si128(_mm_cmpeq_epi8(f, open), _mm_cmpeq_epi8(f, close))));
+                        if (mask) return p + countTrailingZeros(static_cast<uint64_t>(mask));
+                    }
+                    return scanBracketsScalar(p, end);
+                }
+            #endif
+
+            #if HMS_JSON_SIMD_AVX2
+                HMS_JSON_TARGET_AVX2 const char* scanLiteralAvx2(const char* p, const char* end, bool stopOnNonAscii) {
+                    const __m256i quote     = _mm256_set1_epi8('"');
+                    const __m256i slash     = _mm256_set1_epi8('\\');
+                    const uint32_t highMask = stopOnNonAscii ? 0xFFFFFFFFu : 0;
+                    for (; end - p >= 32; p += 32) {
+                        __m256i v       = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                        uint32_t mask   = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, slash))))
+                                        | (static_cast<uint32_t>(_mm256_movemask_epi8(v)) & highMask);
+                        if (mask) return p + countTrailingZeros(mask);
+                    }
+                    return scanLiteralScalar(p, end, stopOnNonAscii);
+                }
+
+                HMS_JSON_TARGET_AVX2 const char* scanEscapesAvx2(const char* p, const char* end) {
+                    const __m256i quote = _mm256_set1_epi8('"');
+                    const __m256i slash = _mm256_set1_epi8('\\');
+                    const __m256i ctrl  = _mm256_set1_epi8(0x1F);
+                    const __m256i zero  = _mm256_setzero_si256();
+                    for (; end - p >= 32; p += 32) {
+                        __m256i v       = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                        __m256i low     = _mm256_cmpeq_epi8(_mm256_subs_epu8(v, ctrl), zero);
+                        uint32_t mask   = static_cast<uint32_t>(_mm256_movemask_epi8(
+                            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, slash)), low)));
+                        if (mask) return p + countTrailingZeros(mask);
+                    }
+                    return scanEscapesScalar(p, end);
+                }
+
+                HMS_JSON_TARGET_AVX2 const char* scanBracketsAvx2(const char* p, const char* end) {
+                    const __m256i quote = _mm256_set1_epi8('"');
+                    const __m256i bit   = _mm256_set1_epi8(0x20);
+                    const __m256i open  = _mm256_set1_epi8('{');
+                    const __m256i close = _mm256_set1_epi8('}');
+                    for (; end - p >= 32; p += 32) {
+                        __m256i v       = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                        __m256i f       = _mm256_or_si256(v, bit);
+                        uint32_t mask   = static_cast<uint32_t>(_mm256_movemask_epi8(
+                            _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_or_si256(_mm256_cmpeq_epi8(f, open), _mm256_cmpeq_epi8(f, close)))));
+                        if (mask) return p + countTrailingZeros(mask);
+                    }
+                    return scanBracketsScalar(p, end);
+                }
+            #endif
+
+            using LiteralScanner = const char* (*)(const char*, const char*, bool);
+            using RangeScanner   = const char* (*)(const char*, const char*);
+
+            // Picked on first use rather than by a namespace scope initializer, so parsing from
+            // another translation unit's static constructors never sees an unset pointer.
+            struct Scanners {
+                LiteralScanner literal;
+                RangeScanner   escapes;
+                RangeScanner   brackets;
+            };
+
+            const Scanners& scanners() {
+                #if HMS_JSON_SIMD_AVX2
+                    static const Scanners picked = cpuHasAvx2()
+                        ? Scanners{ scanLiteralAvx2, scanEscapesAvx2, scanBracketsAvx2 }
+                        : Scanners{ scanLiteralSse2, scanEscapesSse2, scanBracketsSse2 };
+                #elif HMS_JSON_SIMD_SSE2
+                    static const Scanners picked{ scanLiteralSse2, scanEscapesSse2, scanBracketsSse2 };
+                #else
+                    static const Scanners picked{ scanLiteralScalar, scanEscapesScalar, scanBracketsScalar };
+                #endif
+                return picked;
+            }
+        }
+
+        // Keys and short values end within a few bytes, so the first bytes are checked inline
+        // before paying for the dispatched vector loop.
+        const char* scanStringLiteral(const char* p, const char* end, bool stopOnNonAscii) {
+            for (int i = 0; i < 8 && p < end; ++i, ++p) {
+                if (isLiteralStop(*p, stopOnNonAscii)) return p;
+            }
+            return scanners().literal(p, end, stopOnNonAscii);
+        }
+
+        const char* scanEscapes(const char* p, const char* end) {
+            for (int i = 0; i < 8 && p < end; ++i, ++p) {
+                if (isEscapeStop(*p)) return p;
+            }
+            return scanners().escapes(p, end);
+        }
+
+        const char* scanBrackets(const char* p, const char* end) {
+            return scanners().brackets(p, end);
+        }
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef HMS_JSON_STRINGS_H
+#define HMS_JSON_STRINGS_H
+
+#include "HMS_JSON_Config.h"
+
+namespace HMS {
+    namespace detail {
+        /*
+         * Scanners for the long clean runs inside string literals. They look at 16 or 32 bytes per
+         * step where SSE2/AVX2 are available and fall back to a byte loop elsewhere, so callers can
+         * bulk copy everything before the returned position.
+         */
+
+        // First '"' or '\\' in [p, end), or any byte >= 0x80 when stopOnNonAscii is set.
+        const char* scanStringLiteral(const char* p, const char* end, bool stopOnNonAscii);
+
+        // First byte the serializer has to escape: '"', '\\' or a control character below 0x20.
+        const char* scanEscapes(const char* p, const char* end);
+
+        // First '"', '[', ']', '{' or '}' in [p, end); used to skip whole subtrees.
+        const char* scanBrackets(const char* p, const char* end);
+    }
+}
+
+#endif // HMS_JSON_STRINGS_H
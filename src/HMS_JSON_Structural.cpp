@@ -0,0 +1,183 @@
+#include "HMS_JSON_Structural.h"
+#include "HMS_JSON_Unicode.h"
+#include "HMS_JSON_Simd.h"
+
+#include <cstring>
+
+namespace HMS {
+    namespace detail {
+        namespace {
+            struct BlockMasks {
+                uint64_t quote;
+                uint64_t backslash;
+                uint64_t op;                // { } [ ] : ,
+                uint64_t space;             // JSON whitespace
+                uint64_t high;              // bytes >= 0x80
+            };
+
+            using Classifier = void (*)(const unsigned char* block, BlockMasks& m);
+
+            #if HMS_JSON_SIMD_SSE2
+                void classifySse2(const unsigned char* block, BlockMasks& m) {
+                    const __m128i quote = _mm_set1_epi8('"'),   slash = _mm_set1_epi8('\\');
+                    const __m128i lbrace = _mm_set1_epi8('{'),  rbrace = _mm_set1_epi8('}');
+                    const __m128i lbrack = _mm_set1_epi8('['),  rbrack = _mm_set1_epi8(']');
+                    const __m128i colon = _mm_set1_epi8(':'),   comma = _mm_set1_epi8(',');
+                    const __m128i sp = _mm_set1_epi8(' '),      tab = _mm_set1_epi8('\t');
+                    const __m128i lf = _mm_set1_epi8('\n'),     cr = _mm_set1_epi8('\r');
+                    m = BlockMasks{0, 0, 0, 0, 0};
+                    for (int i = 0; i < 4; ++i) {
+                        __m128i v   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+                        __m128i op  = _mm_or_si128(
+                            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, lbrace), _mm_cmpeq_epi8(v, rbrace)),
+                                         _mm_or_si128(_mm_cmpeq_epi8(v, lbrack), _mm_cmpeq_epi8(v, rbrack))),
+                            _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+                        __m128i ws  = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, tab)),
+                                                   _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+                        unsigned shift = 16u * static_cast<unsigned>(i);
+                        m.quote     |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << shift;
+                        m.backslash |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, slash)))) << shift;
+                        m.op        |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(op))) << shift;
+                        m.space     |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(ws))) << shift;
+                        m.high      |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(v))) << shift;
+                    }
+                }
+            #endif
+
+            #if HMS_JSON_SIMD_AVX2
+                HMS_JSON_TARGET_AVX2 void classifyAvx2(const unsigned char* block, BlockMasks& m) {
+                    const __m256i quote = _mm256_set1_epi8('"'),    slash = _mm256_set1_epi8('\\');
+                    const __m256i lbrace = _mm256_set1_epi8('{'),   rbrace = _mm256_set1_epi8('}');
+                    const __m256i lbrack = _mm256_set1_epi8('['),   rbrack = _mm256_set1_epi8(']');
+                    const __m256i colon = _mm256_set1_epi8(':'),    comma = _mm256_set1_epi8(',');
+                    const __m256i sp = _mm256_set1_epi8(' '),       tab = _mm256_set1_epi8('\t');
+                    const __m256i lf = _mm256_set1_epi8('\n'),      cr = _mm256_set1_epi8('\r');
+                    m = BlockMasks{0, 0, 0, 0, 0};
+                    for (int i = 0; i < 2; ++i) {
+                        __m256i v   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32 * i));
+                        __m256i op  = _mm256_or_si256(
+                            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, lbrace), _mm256_cmpeq_epi8(v, rbrace)),
+                                            _mm256_or_si256(_mm256_cmpeq_epi8(v, lbrack), _mm256_cmpeq_epi8(v, rbrack))),
+                            _mm256_or_si256(_mm256_cmpeq_epi8(v, colon), _mm256_cmpeq_epi8(v, comma)));
+                        __m256i ws  = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, sp), _mm256_cmpeq_epi8(v, tab)),
+                                                      _mm256_or_si256(_mm256_cmpeq_epi8(v, lf), _mm256_cmpeq_epi8(v, cr)));
+                        unsigned shift = 32u * static_cast<unsigned>(i);
+                        m.quote     |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)))) << shift;
+                        m.backslash |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, slash)))) << shift;
+                        m.op        |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(op))) << shift;
+                        m.space     |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(ws))) << shift;
+                        m.high      |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(v))) << shift;
+                    }
+                }
+            #endif
+
+            Classifier pickClassifier() {
+                #if HMS_JSON_SIMD_AVX2
+                    if (cpuHasAvx2()) return classifyAvx2;
+                #endif
+                #if HMS_JSON_SIMD_SSE2
+                    return classifySse2;
+                #else
+                    return nullptr;
+                #endif
+            }
+
+            // Resolved on first use, a namespace scope pointer would still be null while other
+            // translation units run their static constructors.
+            Classifier classifier() {
+                static const Classifier picked = pickClassifier();
+                return picked;
+            }
+
+            // Bit i set when byte i is escaped by an unescaped backslash before it. Backslashes are
+            // rare outside of long escaped strings, so walking them one by one is cheap.
+            uint64_t escapedBytes(uint64_t backslash, uint64_t& carry) {
+                uint64_t escaped = carry;
+                carry = 0;
+                while (backslash) {
+                    unsigned i = countTrailingZeros(backslash);
+                    backslash &= backslash - 1;
+                    if ((escaped >> i) & 1) continue;
+                    if (i == 63) carry = 1;
+                    else escaped |= uint64_t(1) << (i + 1);
+                }
+                return escaped;
+            }
+
+            uint64_t prefixXor(uint64_t x) {
+                x ^= x << 1;
+                x ^= x << 2;
+                x ^= x << 4;
+                x ^= x << 8;
+                x ^= x << 16;
+                x ^= x << 32;
+                return x;
+            }
+        }
+
+        bool structuralIndexAvailable() {
+            return classifier() != nullptr;
+        }
+
+        bool buildStructuralIndex(std::string_view src, std::vector<uint32_t>& tokens, size_t& badUtf8) {
+            badUtf8 = static_cast<size_t>(-1);
+            const Classifier classify = classifier();
+            if (!classify || src.size() >= UINT32_MAX) return false;
+
+            const unsigned char* data   = reinterpret_cast<const unsigned char*>(src.data());
+            const unsigned char* end    = data + src.size();
+            size_t   count              = 0;
+            uint64_t escapeCarry        = 0;
+            uint64_t inStringCarry      = 0;
+            uint64_t scalarCarry        = 0;
+            size_t   utf8Resume         = 0;
+            unsigned char tail[64];
+
+            tokens.resize(src.size() / 8 + 64);
+            for (size_t base = 0; base < src.size(); base += 64) {
+                const unsigned char* block = data + base;
+                if (src.size() - base < 64) {
+                    std::memset(tail, ' ', sizeof(tail));
+                    std::memcpy(tail, block, src.size() - base);
+                    block = tail;
+                }
+
+                BlockMasks m;
+                classify(block, m);
+
+                uint64_t escaped    = m.backslash | escapeCarry ? escapedBytes(m.backslash, escapeCarry) : 0;
+                uint64_t quotes     = m.quote & ~escaped;
+                uint64_t inString   = prefixXor(quotes) ^ inStringCarry;
+                inStringCarry       = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+
+                uint64_t scalar     = ~(m.op | m.space | quotes | inString);
+                uint64_t starts     = scalar & ~((scalar << 1) | scalarCarry);
+                scalarCarry         = scalar >> 63;
+
+                uint64_t structural = (m.op & ~inString) | (quotes & inString) | starts;
+
+                if (HMS_JSON_UNLIKELY(m.high)) {
+                    size_t stop = base + 64 < src.size() ? base + 64 : src.size();
+                    size_t i    = utf8Resume > base ? utf8Resume : base;
+                    while (i < stop) {
+                        if (data[i] < 0x80) { ++i; continue; }
+                        size_t len = utf8SequenceLength(data + i, end);
+                        if (!len) { badUtf8 = i; return true; }
+                        i += len;
+                    }
+                    utf8Resume = i;
+                }
+
+                if (tokens.size() < count + 64) tokens.resize(tokens.size() * 2 + 64);
+                uint32_t* out = tokens.data() + count;
+                count += popCount(structural);
+                while (structural) {
+                    *out++ = static_cast<uint32_t>(base + countTrailingZeros(structural));
+                    structural &= structural - 1;
+                }
+            }
+            tokens.resize(count);
+            return true;
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef HMS_JSON_STRUCTURAL_H
+#define HMS_JSON_STRUCTURAL_H
+
+#include "HMS_JSON_Config.h"
+
+#ifndef HMS_JSON_STRUCTURAL_MIN_SIZE
+#define HMS_JSON_STRUCTURAL_MIN_SIZE 128        // smaller inputs are parsed byte by byte
+#endif
+
+namespace HMS {
+    namespace detail {
+        /*
+         * Stage one of the two stage parse. Classifies the input 64 bytes at a time with vector
+         * compares and records the offset of every token start outside strings: the structural
+         * characters { } [ ] : , the opening quote of each string and the first byte of each
+         * scalar (number or literal). The whole input is validated as UTF-8 on the way. The index
+         * covers the whole input at 4 bytes per token: about half the input size for typical
+         * documents, up to four times it for arrays of one digit numbers.
+         *
+         * Returns false when no vector kernel is available on this CPU or the input is too large
+         * for 32 bit offsets; the caller then parses byte by byte. On invalid UTF-8 it returns true
+         * with badUtf8 set to the offset of the offending byte.
+         */
+        bool buildStructuralIndex(std::string_view src, std::vector<uint32_t>& tokens, size_t& badUtf8);
+
+        bool structuralIndexAvailable();
+    }
+}
+
+#endif // HMS_JSON_STRUCTURAL_H
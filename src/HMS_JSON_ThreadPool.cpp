@@ -0,0 +1,135 @@
+#include "HMS_JSON_ThreadPool.h"
+
+#ifndef HMS_JSON_NO_THREADS
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <exception>
+#endif
+
+namespace HMS {
+    namespace detail {
+        #ifdef HMS_JSON_NO_THREADS
+            unsigned defaultThreads() { return 1; }
+
+            void parallelFor(size_t count, unsigned, const std::function<void(size_t)>& task) {
+                for (size_t i = 0; i < count; ++i) task(i);
+            }
+        #else
+            namespace {
+                class ThreadPool {
+                    public:
+
+                        ~ThreadPool() {
+                            {
+                                std::lock_guard<std::mutex> lock(mutex);
+                                stop = true;
+                            }
+                            wake.notify_all();
+                            for (auto& t : workers) t.join();
+                        }
+
+                        void run(size_t count, unsigned threads, const std::function<void(size_t)>& task) {
+                            if (threads > count) threads = static_cast<unsigned>(count);
+                            std::unique_lock<std::mutex> busy(runMutex, std::try_to_lock);
+                            if (threads <= 1 || !busy.owns_lock()) {
+                                for (size_t i = 0; i < count; ++i) task(i);
+                                return;
+                            }
+                            // Workers are started on first use and kept for later jobs.
+                            while (workers.size() < threads - 1) workers.emplace_back([this] { work(); });
+
+                            {
+                                std::lock_guard<std::mutex> lock(mutex);
+                                job     = &task;
+                                total   = count;
+                                wanted  = threads - 1;
+                                next.store(0, std::memory_order_relaxed);
+                                generation++;
+                            }
+                            wake.notify_all();
+                            drain(task);
+
+                            // No worker may join once job is cleared, so task can go out of scope.
+                            std::unique_lock<std::mutex> lock(mutex);
+                            idle.wait(lock, [this] { return running == 0; });
+                            job = nullptr;
+                            std::exception_ptr thrown = failure;
+                            failure = nullptr;
+                            lock.unlock();
+                            if (thrown) std::rethrow_exception(thrown);
+                        }
+
+                    private:
+                        std::vector<std::thread>                workers;
+                        std::mutex                              runMutex;   // one parallel job at a time
+                        std::mutex                              mutex;
+                        std::condition_variable                 wake;
+                        std::condition_variable                 idle;
+                        const std::function<void(size_t)>*      job         = nullptr;
+                        size_t                                  total       = 0;
+                        std::atomic<size_t>                     next{0};
+                        unsigned                                wanted      = 0;    // workers still allowed to join
+                        unsigned                                running     = 0;
+                        unsigned                                generation  = 0;
+                        bool                                    stop        = false;
+                        std::exception_ptr                      failure;                // first exception of the current job
+
+                        // A throwing task ends the job: the remaining ones are skipped and run() rethrows
+                        // the first exception on the caller once every thread has left the job.
+                        void drain(const std::function<void(size_t)>& task) {
+                            #if defined(__cpp_exceptions)
+                                try {
+                                    for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < total; ) task(i);
+                                } catch (...) {
+                                    next.store(total, std::memory_order_relaxed);
+                                    std::lock_guard<std::mutex> lock(mutex);
+                                    if (!failure) failure = std::current_exception();
+                                }
+                            #else
+                                for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < total; ) task(i);
+                            #endif
+                        }
+
+                        void work() {
+                            unsigned seen = 0;
+                            std::unique_lock<std::mutex> lock(mutex);
+                            while (true) {
+                                wake.wait(lock, [&] { return stop || generation != seen; });
+                                if (stop) return;
+                                seen = generation;
+                                if (!job || wanted == 0) continue;
+                                wanted--;
+                                running++;
+                                const std::function<void(size_t)>& task = *job;
+                                lock.unlock();
+                                drain(task);
+                                lock.lock();
+                                if (--running == 0) idle.notify_all();
+                            }
+                        }
+                };
+
+                ThreadPool& sharedPool() {
+                    static ThreadPool pool;
+                    return pool;
+                }
+            }
+
+            unsigned defaultThreads() {
+                unsigned n = std::thread::hardware_concurrency();
+                return n ? n : 1;
+            }
+
+            void parallelFor(size_t count, unsigned threads, const std::function<void(size_t)>& task) {
+                if (threads == 0) threads = defaultThreads();
+                if (threads <= 1 || count <= 1) {
+                    for (size_t i = 0; i < count; ++i) task(i);
+                    return;
+                }
+                sharedPool().run(count, threads, task);
+            }
+        #endif
+    }
+}
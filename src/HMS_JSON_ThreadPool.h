@@ -0,0 +1,24 @@
+#ifndef HMS_JSON_THREADPOOL_H
+#define HMS_JSON_THREADPOOL_H
+
+#include "HMS_JSON_Config.h"
+
+#include <functional>
+
+namespace HMS {
+    namespace detail {
+        // Worker count used when a caller asks for 0 threads: the hardware concurrency, 1 without threads.
+        unsigned defaultThreads();
+
+        /*
+         * Runs task(0) .. task(count - 1) on up to `threads` threads, the calling thread included,
+         * and returns once all of them finished. Workers come from one pool shared by the whole
+         * library that grows to the largest thread count asked for; a call made while the pool is
+         * busy (e.g. from inside a task) runs serially on the caller. If a task throws, tasks not yet
+         * started are skipped and the first exception is rethrown on the caller after the others end.
+         */
+        void parallelFor(size_t count, unsigned threads, const std::function<void(size_t)>& task);
+    }
+}
+
+#endif // HMS_JSON_THREADPOOL_H
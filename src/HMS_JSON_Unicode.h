@@ -0,0 +1,51 @@
+#ifndef HMS_JSON_UNICODE_H
+#define HMS_JSON_UNICODE_H
+
+#include "HMS_JSON_Config.h"
+
+namespace HMS {
+    namespace detail {
+        // Length of the well formed UTF-8 sequence starting at p, 0 when it is malformed, overlong,
+        // a surrogate or above U+10FFFF.
+        inline size_t utf8SequenceLength(const unsigned char* p, const unsigned char* end) {
+            unsigned char c = p[0];
+            if (c < 0x80) return 1;
+            size_t avail = static_cast<size_t>(end - p);
+            if (c >= 0xC2 && c <= 0xDF) {
+                return (avail >= 2 && (p[1] & 0xC0) == 0x80) ? 2 : 0;
+            }
+            if (c >= 0xE0 && c <= 0xEF) {
+                if (avail < 3 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80) return 0;
+                if (c == 0xE0 && p[1] < 0xA0) return 0;                      // overlong
+                if (c == 0xED && p[1] > 0x9F) return 0;                      // surrogate
+                return 3;
+            }
+            if (c >= 0xF0 && c <= 0xF4) {
+                if (avail < 4 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80) return 0;
+                if (c == 0xF0 && p[1] < 0x90) return 0;                      // overlong
+                if (c == 0xF4 && p[1] > 0x8F) return 0;                      // above U+10FFFF
+                return 4;
+            }
+            return 0;
+        }
+
+        inline void appendUtf8(std::string& out, unsigned code) {
+            if (code <= 0x7F) out.push_back(static_cast<char>(code));
+            else if (code <= 0x7FF) {
+                out.push_back(static_cast<char>(0xC0 | ((code >> 6) & 0x1F)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            } else if (code <= 0xFFFF) {
+                out.push_back(static_cast<char>(0xE0 | ((code >> 12) & 0x0F)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            } else {
+                out.push_back(static_cast<char>(0xF0 | ((code >> 18) & 0x07)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+        }
+    }
+}
+
+#endif // HMS_JSON_UNICODE_H
@@ -0,0 +1,87 @@
+#include "HMS_JSON_Writer.h"
+#include "HMS_JSON_Serializer.h"
+
+namespace HMS {
+    // Separator and indentation in front of an array element or an object key, laid out the way
+    // JsonSerializer lays out a tree.
+    void JsonWriter::separate() {
+        if (afterKey) { afterKey = false; return; }
+        if (stack.empty()) return;
+        if (!first) pretty ? out.write(",\n", 2) : out.put(',');
+        else if (pretty) out.put('\n');
+        first = false;
+        if (pretty) out.fill(' ', stack.size() * static_cast<size_t>(indent));
+    }
+
+    JsonWriter& JsonWriter::open(char bracket, char closing) {
+        separate();
+        out.put(bracket);
+        stack.push_back(closing);
+        first = true;
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::close() {
+        char closing = stack.back();
+        stack.pop_back();
+        if (pretty && !first) { out.put('\n'); out.fill(' ', stack.size() * static_cast<size_t>(indent)); }
+        out.put(closing);
+        first = false;
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::beginObject()   { return open('{', '}'); }
+    JsonWriter& JsonWriter::endObject()     { return close(); }
+    JsonWriter& JsonWriter::beginArray()    { return open('[', ']'); }
+    JsonWriter& JsonWriter::endArray()      { return close(); }
+
+    JsonWriter& JsonWriter::key(std::string_view k) {
+        separate();
+        JsonSerializer::writeString(out, k);
+        pretty ? out.write(": ", 2) : out.put(':');
+        afterKey = true;
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::value(std::nullptr_t) {
+        separate();
+        out.write("null", 4);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::value(bool b) {
+        separate();
+        b ? out.write("true", 4) : out.write("false", 5);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::value(double d) {
+        separate();
+        JsonSerializer::writeDouble(out, d);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::value(long long i) {
+        separate();
+        JsonSerializer::writeInteger(out, static_cast<int64_t>(i));
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::value(unsigned long long u) {
+        separate();
+        JsonSerializer::writeInteger(out, static_cast<uint64_t>(u));
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::value(std::string_view s) {
+        separate();
+        JsonSerializer::writeString(out, s);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::value(const JsonValue& v) {
+        separate();
+        JsonSerializer::writeValue(out, v, pretty, indent, static_cast<int>(stack.size()));
+        return *this;
+    }
+}
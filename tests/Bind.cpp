@@ -0,0 +1,71 @@
+/*
+ * Structs declared with HMS_JSON_DEFINE: integers of every width survive toJson()/fromJson().
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+#include <limits>
+
+namespace {
+    struct Counters {
+        int         small   = 1;
+        int64_t     wide    = 1;
+        uint64_t    count   = 1;
+        uint8_t     byte    = 1;
+    };
+    HMS_JSON_DEFINE(Counters, small, wide, count, byte)
+
+    struct Point { int x = 1; };
+    HMS_JSON_DEFINE(Point, x)
+
+    struct Sample { float f = 0; double d = 0; };
+    HMS_JSON_DEFINE(Sample, f, d)
+
+    bool roundTrip(const Counters& in, Counters& out) {
+        HMS::ParseError err;
+        return HMS::fromJson(HMS::toJson(in), out, err) && !err;
+    }
+}
+
+int main() {
+    HMS::ParseError err;
+
+    Point p;
+    CHECK(HMS::fromJson("{\"x\":0}", p, err) && p.x == 0);
+    p.x = 1;
+    CHECK(HMS::fromJson("{\"x\":-0}", p, err) && p.x == 0);
+    p.x = 1;
+    CHECK(HMS::fromJson("{\"x\":0.0}", p, err) && p.x == 0);
+    CHECK(HMS::fromJson("{\"x\":1.0}", p, err) && p.x == 1);
+    CHECK(HMS::fromJson("{\"x\":-2e0}", p, err) && p.x == -2);
+    CHECK(HMS::fromJson("{\"x\":1e0}", p, err) && p.x == 1);
+    CHECK(!HMS::fromJson("{\"x\":0.5}", p, err) && err.what == "Expected integer");
+    CHECK(!HMS::fromJson("{\"x\":1e300}", p, err) && err.what == "Number out of range");
+
+    Counters zero{ 0, 0, 0, 0 };
+    Counters out;
+    CHECK(roundTrip(zero, out));
+    CHECK(out.small == 0 && out.wide == 0 && out.count == 0 && out.byte == 0);
+
+    Counters negative{ -42, INT64_MIN, 0, 0 };
+    CHECK(roundTrip(negative, out));
+    CHECK(out.small == -42 && out.wide == INT64_MIN);
+
+    Counters max{ std::numeric_limits<int>::max(), INT64_MAX, UINT64_MAX, 255 };
+    CHECK(roundTrip(max, out));
+    CHECK(out.small == std::numeric_limits<int>::max() && out.wide == INT64_MAX && out.count == UINT64_MAX && out.byte == 255);
+
+    CHECK(!HMS::fromJson("{\"byte\":256}", out, err) && err);
+    CHECK(!HMS::fromJson("{\"count\":-1}", out, err) && err);
+    CHECK(!HMS::fromJson("{\"count\":-1.0}", out, err) && err.what == "Number out of range");
+    CHECK(HMS::fromJson("{\"count\":-0.0}", out, err) && out.count == 0);
+
+    Sample s;
+    CHECK(HMS::fromJson("{\"f\":1.5,\"d\":1e300}", s, err) && s.f == 1.5f && s.d == 1e300);
+    CHECK(HMS::fromJson("{\"f\":-3.4e38}", s, err) && s.f == -3.4e38f);
+    CHECK(!HMS::fromJson("{\"f\":1e300}", s, err) && err.what == "Number out of range");
+    CHECK(!HMS::fromJson("{\"f\":-1e39}", s, err) && err.what == "Number out of range");
+
+    return HMS::Test::result();
+}
@@ -0,0 +1,49 @@
+/*
+ * JsonCbor: round trips, and decoding hostile input without exhausting the stack.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+namespace {
+    HMS::JsonValue decode(const std::vector<uint8_t>& bytes, HMS::ParseError& err) {
+        return HMS::JsonCbor::decode(bytes.data(), bytes.size(), err);
+    }
+}
+
+int main() {
+    HMS::ParseError err;
+
+    const char* text = "{\"a\":[0,-1,1.5,\"x\",true,null],\"b\":{\"c\":18446744073709551615}}";
+    HMS::JsonValue v = HMS::deserialize(text, err);
+    HMS::JsonValue back = decode(HMS::JsonCbor::encode(v), err);
+    CHECK(!err);
+    CHECK(HMS::serialize(back) == text);
+
+    // A million tags in front of one item are skipped without recursion.
+    std::vector<uint8_t> tags(1000000, 0xC0);
+    tags.push_back(0x01);
+    HMS::JsonValue tagged = decode(tags, err);
+    CHECK(!err && tagged.asInt64() == 1);
+
+    std::vector<uint8_t> unfinished(1000000, 0xC0);
+    decode(unfinished, err);
+    CHECK(err && err.what == "Unexpected end of input");
+
+    // Nesting is bounded, both for definite and indefinite containers.
+    std::vector<uint8_t> arrays(1000000, 0x81);
+    decode(arrays, err);
+    CHECK(err && err.what == "Nesting too deep");
+
+    std::vector<uint8_t> maps;
+    for (int i = 0; i < 100000; ++i) { maps.push_back(0xBF); maps.push_back(0x61); maps.push_back('k'); }
+    decode(maps, err);
+    CHECK(err && err.what == "Nesting too deep");
+
+    std::vector<uint8_t> allowed(HMS_JSON_CBOR_MAX_DEPTH, 0x81);
+    allowed.push_back(0xF6);
+    decode(allowed, err);
+    CHECK(!err);
+
+    return HMS::Test::result();
+}
@@ -0,0 +1,35 @@
+/*
+ * HMS_JSON Library - Tests
+ *
+ * Minimal checks for the test programs: every failed CHECK prints its location and the program
+ * exits non zero at the end, so one run reports all failures of a file.
+ */
+
+#ifndef HMS_JSON_TESTS_CHECK_H
+#define HMS_JSON_TESTS_CHECK_H
+
+#include <cstdio>
+
+namespace HMS {
+    namespace Test {
+        inline int& failures() {
+            static int count = 0;
+            return count;
+        }
+
+        inline int result() {
+            if (failures()) std::fprintf(stderr, "%d check(s) failed\n", failures());
+            return failures() ? 1 : 0;
+        }
+    }
+}
+
+#define CHECK(cond)                                                                         \
+    do {                                                                                    \
+        if (!(cond)) {                                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);   \
+            HMS::Test::failures()++;                                                        \
+        }                                                                                   \
+    } while (0)
+
+#endif // HMS_JSON_TESTS_CHECK_H
@@ -0,0 +1,36 @@
+/*
+ * deserializeFile(): Tree mode releases the file once parsed, Lazy mode keeps it mapped.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+#include <cstdio>
+
+int main() {
+    const char* path = "hms_json_test_file.json";
+    const char* text = "{\"name\":\"file\",\"records\":[{\"id\":1},{\"id\":2}]}";
+    std::FILE* f = std::fopen(path, "wb");
+    CHECK(f != nullptr);
+    if (!f) return HMS::Test::result();
+    std::fputs(text, f);
+    std::fclose(f);
+
+    HMS::ParseError err;
+    HMS::JsonFile tree = HMS::deserializeFile(path, err);
+    CHECK(!err);
+    CHECK(HMS::serialize(tree.root()) == text);
+    CHECK(tree.text().empty());
+
+    HMS::JsonFile lazy = HMS::deserializeFile(path, err, HMS::JsonFileMode::Lazy);
+    CHECK(!err);
+    CHECK(lazy.text() == text);
+    CHECK(lazy.root().isNull());
+    CHECK(lazy.lazy()["name"].asString(err) == "file");
+
+    HMS::deserializeFile("hms_json_test_missing.json", err);
+    CHECK(err);
+
+    std::remove(path);
+    return HMS::Test::result();
+}
@@ -0,0 +1,100 @@
+/*
+ * JsonKey and JsonKeyTable (HMS_JSON_INTERN_KEYS builds): one copy of each distinct key within a
+ * table, keys outliving their table, and the tables the parsers and JsonDocument set up.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+#ifdef HMS_JSON_INTERN_KEYS
+#ifndef HMS_JSON_NO_THREADS
+#include <thread>
+#endif
+
+namespace {
+    const HMS::JsonKey& firstKey(const HMS::JsonValue& object) { return object.asObject().begin()->first; }
+}
+
+int main() {
+    // Keys made without a table own their text, equal keys still compare equal.
+    HMS::JsonKey a("name"), b(std::string("name")), c("other");
+    CHECK(a == b && a.data() != b.data());
+    CHECK(a != c && a < c && !(c < a));
+    CHECK(a == "name" && "name" == a && a != std::string("x") && a < std::string_view("nb"));
+    CHECK(a.size() == 4 && a.str() == "name" && a.c_str()[4] == '\0');
+    CHECK(HMS::JsonKey().empty() && HMS::JsonKey("").empty() && HMS::JsonKey("") == HMS::JsonKey());
+
+    HMS::JsonKey copy = a;
+    CHECK(copy.data() == a.data());
+    HMS::JsonKey moved = std::move(copy);
+    CHECK(moved.data() == a.data() && copy.empty());
+
+    // A table stores each distinct key once, also while it grows.
+    HMS::JsonKeyTable table;
+    std::vector<HMS::JsonKey> keys;
+    for (int i = 0; i < 5000; ++i) keys.push_back(table.intern("key" + std::to_string(i)));
+    CHECK(table.size() == 5000);
+    bool shared = true;
+    for (int i = 0; i < 5000; ++i) shared = shared && table.intern("key" + std::to_string(i)).data() == keys[static_cast<size_t>(i)].data();
+    CHECK(shared && table.size() == 5000);
+    CHECK(table.intern("").empty() && table.size() == 5000);
+
+    // Keys created under a scope come from its table, keys keep their text after it is gone.
+    {
+        HMS::JsonKeyTable scoped;
+        HMS::JsonKeyScope scope(scoped);
+        CHECK(HMS::JsonKeyTable::current() == &scoped);
+        CHECK(HMS::JsonKey("k").data() == HMS::JsonKey(std::string("k")).data());
+        HMS::JsonValue v;
+        v["built"] = 1;
+        CHECK(firstKey(v).data() == scoped.intern("built").data());
+        a = HMS::JsonKey("survivor");
+    }
+    CHECK(HMS::JsonKeyTable::current() == nullptr);
+    CHECK(a == "survivor");
+
+    // One parse shares a table between all its objects, separate parses do not.
+    HMS::ParseError err;
+    HMS::JsonValue first  = HMS::deserialize("[{\"id\":1},{\"id\":2},{\"n\":{\"id\":3}}]", err);
+    HMS::JsonValue second = HMS::deserialize("{\"id\":4}", err);
+    CHECK(!err);
+    CHECK(firstKey(first[0]).data() == firstKey(first[1]).data());
+    CHECK(firstKey(first[2]["n"]).data() == firstKey(first[0]).data());
+    CHECK(firstKey(second).data() != firstKey(first[0]).data());
+    CHECK(HMS::serialize(first) == "[{\"id\":1},{\"id\":2},{\"n\":{\"id\":3}}]");
+
+    // A caller's table is used across parses instead.
+    {
+        HMS::JsonKeyTable batch;
+        HMS::JsonKeyScope scope(batch);
+        HMS::JsonValue x = HMS::deserialize("{\"id\":1}", err);
+        HMS::JsonValue y = HMS::deserialize("{\"id\":2,\"z\":0}", err);
+        CHECK(!err && firstKey(x).data() == firstKey(y).data() && batch.size() == 2);
+    }
+
+    // JsonDocument keeps one table for everything parsed into it or built through it.
+    HMS::JsonDocument doc;
+    CHECK(doc.parse("{\"id\":[{\"id\":1}]}", err));
+    doc["added"] = 1;
+    HMS::JsonValue& root = doc.root();
+    CHECK(firstKey(root["id"][0]).data() == root.asObject().find("id")->first.data());
+    CHECK(root.asObject().size() == 2 && root.asObject().find("added")->second.asInt64() == 1);
+
+    #ifndef HMS_JSON_NO_THREADS
+        // Interned keys are shared by reference count, copies on other threads are safe.
+        HMS::JsonValue shared_doc = HMS::deserialize("[{\"k\":1},{\"k\":2}]", err);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 10000; ++i) { HMS::JsonValue c = shared_doc; (void)c; }
+            });
+        }
+        for (auto& t : threads) t.join();
+        CHECK(firstKey(shared_doc[0]).data() == firstKey(shared_doc[1]).data());
+    #endif
+
+    return HMS::Test::result();
+}
+#else
+int main() { return 0; }
+#endif
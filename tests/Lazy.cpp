@@ -0,0 +1,70 @@
+/*
+ * JsonLazyValue: lookups, materializing what was found, and rejecting bad indexes and trailing data.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+int main() {
+    HMS::ParseError err;
+
+    const char* text = " {\"device\":{\"id\":\"a\\u0062\",\"rssi\":-61.5},\"list\":[1,{\"x\":true},null],\"n\":18446744073709551615} ";
+    HMS::JsonLazyValue doc(text);
+    CHECK(doc.exists() && doc.isObject());
+    CHECK(doc.size() == 3);
+
+    // Lookups by key and by index, and iteration.
+    CHECK(doc["device"]["rssi"].asNumber(err) == -61.5 && !err);
+    CHECK(doc["device"]["id"].asString(err) == "ab" && !err);
+    CHECK(doc["list"][1]["x"].asBool(err) && !err);
+    CHECK(doc["list"][2].isNull());
+    CHECK(doc["n"].asUInt64(err) == UINT64_MAX && !err);
+    CHECK(doc["list"].raw() == "[1,{\"x\":true},null]");
+
+    std::string keys;
+    for (HMS::JsonLazyValue m = doc.first(); m.exists(); m = m.next()) keys += m.key();
+    CHECK(keys == "devicelistn");
+
+    // Materializing goes through the full parser.
+    HMS::JsonValue device = doc["device"].materialize(err);
+    CHECK(!err && HMS::serialize(device) == "{\"id\":\"ab\",\"rssi\":-61.5}");
+    HMS::JsonValue whole = doc.materialize(err);
+    CHECK(!err && whole.isObject());
+
+    // Failed lookups do not throw, the reason surfaces once a value is requested.
+    HMS::JsonLazyValue missing = doc["device"]["nope"];
+    CHECK(!missing.exists());
+    missing.asNumber(err);
+    CHECK(err && err.what == "Key not found");
+    CHECK(!doc["list"][3].exists());
+    CHECK(!doc["device"][0].exists());
+    doc["device"]["rssi"].asString(err);
+    CHECK(err && err.what == "Expected string");
+
+    // A negative index is out of range, not a huge unsigned one.
+    HMS::JsonLazyValue negative = doc["list"][-1];
+    CHECK(!negative.exists());
+    negative.materialize(err);
+    CHECK(err && err.what == "Index out of range");
+
+    // Trailing data after the root is rejected, both behind containers and scalars.
+    const char* trailing[] = { "{\"a\":1} x", "[1,2] [3]", "1 2", "\"s\" \"t\"", "true false" };
+    for (const char* t : trailing) {
+        HMS::JsonLazyValue bad(t);
+        CHECK(!bad.exists());
+        bad.materialize(err);
+        CHECK(err && err.what == "Trailing data after JSON");
+    }
+    HMS::JsonLazyValue late("{\"a\":1} }");
+    late["a"].asInt64(err);
+    CHECK(err && err.what == "Trailing data after JSON" && err.pos.col == 9);
+    CHECK(HMS::JsonLazyValue("[1] \n").exists());
+    CHECK(HMS::JsonLazyValue("42").asInt64(err) == 42 && !err);
+
+    HMS::JsonLazyValue empty("  ");
+    CHECK(!empty.exists());
+    empty.materialize(err);
+    CHECK(err && err.what == "Unexpected end of input");
+
+    return HMS::Test::result();
+}
@@ -0,0 +1,53 @@
+/*
+ * JsonLinesReader and the thread pool under it: records stay off the caller's arena, and an
+ * exception thrown by a pool task reaches the caller.
+ */
+
+#include "HMS_JSON.h"
+#include "HMS_JSON_ThreadPool.h"
+#include "Check.h"
+
+#include <atomic>
+#include <new>
+#include <stdexcept>
+
+int main() {
+    std::string log;
+    for (int i = 0; i < 500; ++i) log += "{\"id\":" + std::to_string(i) + ",\"tags\":[\"a\",\"b\"]}\n";
+
+    for (unsigned threads : {1u, 4u}) {
+        HMS::JsonArena arena;
+        HMS::ParseError err;
+        std::vector<HMS::JsonValue> records;
+        {
+            HMS::JsonArenaScope scope(arena);
+            records = HMS::JsonLinesReader(threads).parseAll(log, err);
+            CHECK(HMS::JsonArena::current() == &arena);
+        }
+        CHECK(!err);
+        CHECK(records.size() == 500 && records[499].asObject().begin()->second.asInt64() == 499);
+        CHECK(arena.bytesUsed() == 0);
+    }
+
+    for (unsigned threads : {1u, 4u}) {
+        std::atomic<size_t> ran{0};
+        bool caught = false;
+        try {
+            HMS::detail::parallelFor(64, threads, [&](size_t i) {
+                ran++;
+                if (i == 3) throw std::bad_alloc();
+            });
+        } catch (const std::bad_alloc&) {
+            caught = true;
+        }
+        CHECK(caught);
+        CHECK(ran.load() <= 64);
+
+        // The pool is usable again afterwards.
+        ran = 0;
+        HMS::detail::parallelFor(64, threads, [&](size_t) { ran++; });
+        CHECK(ran.load() == 64);
+    }
+
+    return HMS::Test::result();
+}
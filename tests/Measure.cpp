@@ -0,0 +1,51 @@
+/*
+ * JsonSerializer::measure() and serializeInto(): the exact length without output, and writing into
+ * a caller's buffer with snprintf like truncation.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+    using HMS::JsonSerializer;
+
+    void measured(const HMS::JsonValue& v, bool pretty, int indent) {
+        const std::string text = HMS::serialize(v, pretty, indent);
+        CHECK(JsonSerializer::measure(v, pretty, indent) == text.size());
+
+        // Exact fit, and every truncation point, including nothing at all.
+        std::vector<char> buf(text.size() + 8, '#');
+        CHECK(JsonSerializer::serializeInto(v, buf.data(), text.size(), pretty, indent) == text.size());
+        CHECK(std::string(buf.data(), text.size()) == text && buf[text.size()] == '#');
+        for (size_t cap = 0; cap < text.size(); cap += 1 + cap / 8) {
+            std::fill(buf.begin(), buf.end(), '#');
+            CHECK(JsonSerializer::serializeInto(v, buf.data(), cap, pretty, indent) == text.size());
+            CHECK(std::string(buf.data(), cap) == text.substr(0, cap) && buf[cap] == '#');
+        }
+        CHECK(JsonSerializer::serializeInto(v, nullptr, 0, pretty, indent) == text.size());
+    }
+}
+
+int main() {
+    HMS::ParseError err;
+    HMS::JsonValue doc = HMS::deserialize(
+        "{\"escaped\":\"tab\\t quote\\\" ctrl\\u0001 \\u00e9\",\"n\":[-9223372036854775808,18446744073709551615,0.1,-2.5e-300],"
+        "\"nested\":{\"a\":[[],{},[null,true,false]]},\"s\":\"" + std::string(600, 'x') + "\"}", err);
+    CHECK(!err);
+
+    measured(doc, false, 2);
+    measured(doc, true, 2);
+    measured(doc, true, 0);
+    measured(doc, true, 7);
+    measured(HMS::JsonValue(), false, 2);
+    measured(HMS::JsonValue(1e300), false, 2);
+    measured(HMS::JsonValue(std::string(3 * HMS_JSON_OUTPUT_BUFFER_SIZE, '"')), false, 2);
+
+    // Non finite doubles are written as null and measured as such.
+    CHECK(JsonSerializer::measure(HMS::JsonValue(std::numeric_limits<double>::infinity())) == 4);
+
+    return HMS::Test::result();
+}
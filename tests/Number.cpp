@@ -0,0 +1,45 @@
+/*
+ * Number literals: which JsonValue alternative each one lands in and that it serializes back.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+#include <cmath>
+
+namespace {
+    HMS::JsonValue parse(const char* text) {
+        HMS::ParseError err;
+        HMS::JsonValue v = HMS::deserialize(text, err);
+        CHECK(!err);
+        return v;
+    }
+}
+
+int main() {
+    HMS::JsonValue zero = parse("0");
+    CHECK(zero.type() == HMS::JsonValue::Type::Int64);
+    CHECK(zero.getIf<int64_t>() && *zero.getIf<int64_t>() == 0);
+    CHECK(HMS::serialize(zero) == "0");
+
+    HMS::JsonValue negativeZero = parse("-0");
+    CHECK(negativeZero.type() == HMS::JsonValue::Type::Double);
+    CHECK(negativeZero.asNumber() == 0.0 && std::signbit(negativeZero.asNumber()));
+
+    HMS::JsonValue zeroPointZero = parse("0.0");
+    CHECK(zeroPointZero.type() == HMS::JsonValue::Type::Double);
+    CHECK(zeroPointZero.asNumber() == 0.0 && !std::signbit(zeroPointZero.asNumber()));
+
+    CHECK(parse("[0]").asArray()[0].isInteger());
+    CHECK(parse("{\"x\":0}").asObject().begin()->second.isInteger());
+
+    CHECK(parse("-1").asInt64() == -1);
+    CHECK(parse("9223372036854775807").asInt64() == INT64_MAX);
+    CHECK(parse("-9223372036854775808").asInt64() == INT64_MIN);
+    HMS::JsonValue big = parse("18446744073709551615");
+    CHECK(big.type() == HMS::JsonValue::Type::UInt64 && big.asUInt64() == UINT64_MAX);
+    CHECK(parse("1.5").asNumber() == 1.5);
+    CHECK(parse("1e2").type() == HMS::JsonValue::Type::Double);
+
+    return HMS::Test::result();
+}
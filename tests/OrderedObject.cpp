@@ -0,0 +1,88 @@
+/*
+ * BasicJsonOrderedObject: insertion order, lookups on both sides of the switch from linear search
+ * to the hash index, and erase keeping the index in step. Built with HMS_JSON_ORDERED_OBJECTS it
+ * also checks that parsed documents keep their member order.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+namespace {
+    using Object = HMS::BasicJsonOrderedObject<int>;
+
+    std::string key(int i) { return "k" + std::to_string(i); }
+
+    std::string order(const Object& o) {
+        std::string s;
+        for (const auto& kv : o) s += kv.first + ",";
+        return s;
+    }
+
+    // Every member is found where iteration says it is, and nothing else is found.
+    bool consistent(const Object& o, int limit) {
+        for (const auto& kv : o) {
+            auto it = o.find(kv.first);
+            if (it == o.end() || &*it != &kv || o.at(kv.first) != kv.second) return false;
+        }
+        size_t found = 0;
+        for (int i = 0; i < limit; ++i) found += o.count(key(i));
+        return found == o.size() && !o.contains("missing");
+    }
+}
+
+int main() {
+    const int LIMIT = HMS_JSON_OBJECT_LINEAR_LIMIT;
+
+    // Insertion order, not key order, through every size up to well past the index switch.
+    Object o;
+    std::string expected;
+    for (int i = 0; i < 4 * LIMIT; ++i) {
+        int k = (i * 7) % (4 * LIMIT);
+        o[key(k)] = k;
+        expected += key(k) + ",";
+        CHECK(consistent(o, 4 * LIMIT));
+    }
+    CHECK(order(o) == expected);
+    CHECK(o.size() == static_cast<size_t>(4 * LIMIT));
+
+    // emplace and insert leave existing keys alone.
+    CHECK(!o.emplace(key(3), 99).second && o.at(key(3)) == 3);
+    CHECK(!o.insert({ key(5), 99 }).second && o.at(key(5)) == 5);
+    auto added = o.emplace(std::string("new"), 42);
+    CHECK(added.second && added.first->second == 42 && o.find("new") == added.first);
+    CHECK(o.erase("new") == 1 && o.erase("new") == 0);
+
+    // Erasing shifts the later members, the index has to follow, also back below the limit.
+    while (o.size() > 1) {
+        auto at = static_cast<std::ptrdiff_t>(o.size() / 2);
+        std::string name = o.begin()[at].first;
+        std::string next = at + 1 < static_cast<std::ptrdiff_t>(o.size()) ? o.begin()[at + 1].first : std::string();
+        auto after = o.erase(o.cbegin() + at);
+        CHECK(after == o.begin() + at && (after == o.end() || after->first == next));
+        CHECK(!o.contains(name));
+        CHECK(consistent(o, 4 * LIMIT));
+    }
+
+    // Growing again after shrinking below the limit rebuilds the index.
+    for (int i = 0; i < 2 * LIMIT; ++i) o[key(100 + i)] = i;
+    CHECK(consistent(o, 200));
+    CHECK(o.at(key(100 + 2 * LIMIT - 1)) == 2 * LIMIT - 1);
+    o.clear();
+    CHECK(o.empty() && !o.contains(key(100)));
+    o["again"] = 1;
+    CHECK(o.size() == 1 && o.at("again") == 1);
+
+    #ifdef HMS_JSON_ORDERED_OBJECTS
+        HMS::ParseError err;
+        std::string text = "{\"z\":1,\"a\":2,\"m\":{\"y\":true,\"b\":null}";
+        for (int i = 0; i < 2 * LIMIT; ++i) text += ",\"" + key(2 * LIMIT - i) + "\":" + std::to_string(i);
+        text += "}";
+        HMS::JsonValue v = HMS::deserialize(text, err);
+        CHECK(!err && HMS::serialize(v) == text);
+        CHECK(v["k1"].asInt64() == 2 * LIMIT - 1);
+        v.getObject().erase("a");
+        CHECK(HMS::serialize(v) == "{\"z\":1" + text.substr(12));
+    #endif
+
+    return HMS::Test::result();
+}
@@ -0,0 +1,54 @@
+/*
+ * deserializeParallel() and serializeParallel() against their serial counterparts, on documents
+ * large enough to be split: flat arrays, a single dominant member, nested dominant members, and
+ * errors inside the part parsed in parallel.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+namespace {
+    std::string records(size_t n) {
+        std::string s = "[";
+        for (size_t i = 0; i < n; ++i) {
+            if (i) s += ",";
+            s += "{\"id\":" + std::to_string(i) + ",\"name\":\"record \\u00e9 " + std::to_string(i) + "\",\"v\":[1.5,true,null]}";
+        }
+        return s + "]";
+    }
+
+    void same(const std::string& doc) {
+        HMS::ParseError serialErr, parallelErr;
+        HMS::JsonValue serial   = HMS::deserialize(doc, serialErr);
+        HMS::JsonValue parallel = HMS::deserializeParallel(doc, parallelErr, 4);
+        CHECK(serialErr.what == parallelErr.what);
+        CHECK(serialErr.pos.line == parallelErr.pos.line && serialErr.pos.col == parallelErr.pos.col);
+        if (!serialErr) {
+            std::string text = HMS::serialize(serial);
+            CHECK(HMS::serialize(parallel) == text);
+            CHECK(HMS::serializeParallel(serial, false, 2, 4) == text);
+            CHECK(HMS::serializeParallel(serial, true, 2, 4) == HMS::serialize(serial, true));
+        }
+    }
+}
+
+int main() {
+    const std::string big = records(40000);
+    CHECK(big.size() > 2 * HMS_JSON_PARALLEL_MIN_SIZE);
+
+    same(big);
+    same("{\"meta\":{\"n\":1},\"records\":" + big + ",\"tail\":[1,2]}");
+    same("{\"records\":" + big + "}");
+    same("{\"a\":{\"b\":{\"records\":" + big + ",\"x\":0}},\"a\":1}");
+    same("[0," + big + ",\"end\"]");
+
+    // Errors inside the dominant member and around it are reported as by the serial parser.
+    std::string broken = big;
+    broken[broken.size() / 2] = '#';
+    same("{\"records\":" + broken + "}");
+    same("{\"records\":" + big + ",}");
+    same("{\"records\":" + big + "} x");
+    same("{\"meta\":tru,\"records\":" + big + "}");
+
+    return HMS::Test::result();
+}
@@ -0,0 +1,87 @@
+/*
+ * JsonSaxHandler: the event sequence, integer forwarding, and stopping from a callback.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+namespace {
+    // Writes every event as a short token so a whole parse compares as one string.
+    struct Recorder : HMS::JsonSaxHandler {
+        std::string events;
+        std::string_view lastString;
+        int stopAfter = -1;
+
+        bool next(const std::string& e) {
+            events += e;
+            events += ' ';
+            return stopAfter < 0 || --stopAfter > 0;
+        }
+        bool onNull() override                      { return next("null"); }
+        bool onBool(bool b) override                { return next(b ? "true" : "false"); }
+        bool onNumber(double d) override            { return next("d" + HMS::serialize(HMS::JsonValue(d))); }
+        bool onInteger(int64_t v) override          { return next("i" + std::to_string(v)); }
+        bool onUnsigned(uint64_t v) override        { return next("u" + std::to_string(v)); }
+        bool onString(std::string_view s) override  { lastString = s; return next("s:" + std::string(s)); }
+        bool onStartObject() override               { return next("{"); }
+        bool onKey(std::string_view k) override     { return next("k:" + std::string(k)); }
+        bool onEndObject() override                 { return next("}"); }
+        bool onStartArray() override                { return next("["); }
+        bool onEndArray() override                  { return next("]"); }
+    };
+
+    // Only overrides onNumber, integers have to arrive there through the defaults.
+    struct Sum : HMS::JsonSaxHandler {
+        double total = 0;
+        bool onNumber(double d) override { total += d; return true; }
+    };
+}
+
+int main() {
+    HMS::ParseError err;
+
+    Recorder r;
+    const char* text = "{\"a\":[1,-2,18446744073709551615,2.5,true,false,null],\"b\\n\":\"x\\u0041\",\"c\":{},\"d\":[]}";
+    CHECK(HMS::deserialize(text, r, err) && !err);
+    CHECK(r.events == "{ k:a [ i1 i-2 u18446744073709551615 d2.5 true false null ] k:b\n s:xA k:c { } k:d [ ] } ");
+
+    // Literals without escapes are views into the input.
+    Recorder plain;
+    std::string quoted = "\"plain\"";
+    CHECK(HMS::deserialize(quoted, plain, err) && !err);
+    CHECK(plain.lastString.data() == quoted.data() + 1);
+
+    // Long enough for the structural index, the events must not change.
+    std::string big = "[";
+    std::string expected = "[ ";
+    for (int i = 0; i < 100; ++i) {
+        big += (i ? ",{\"k\":" : "{\"k\":") + std::to_string(i) + "}";
+        expected += "{ k:k i" + std::to_string(i) + " } ";
+    }
+    big += "]";
+    expected += "] ";
+    Recorder indexed;
+    CHECK(HMS::deserialize(big, indexed, err) && !err);
+    CHECK(indexed.events == expected);
+
+    Sum sum;
+    CHECK(HMS::deserialize("[1,-2,3.5,18446744073709551615]", sum, err) && !err);
+    CHECK(sum.total == 2.5 + 18446744073709551615.0);
+
+    // Returning false from a callback stops the parse where that value started.
+    Recorder stopped;
+    stopped.stopAfter = 3;
+    CHECK(!HMS::deserialize("[1, 2, 3]", stopped, err));
+    CHECK(err && err.what == "Parsing stopped by handler" && err.pos.col == 5);
+    CHECK(stopped.events == "[ i1 i2 ");
+
+    // Malformed input is reported after the events before it.
+    Recorder bad;
+    CHECK(!HMS::deserialize("[1] 2", bad, err));
+    CHECK(err && err.what == "Trailing data after JSON");
+    CHECK(!HMS::deserialize("{\"a\" 1}", bad, err));
+    CHECK(err && err.what == "Expected ':'");
+    CHECK(HMS::deserialize("[]", bad, err) && !err);
+
+    return HMS::Test::result();
+}
@@ -0,0 +1,70 @@
+/*
+ * serializeParallel() on trees built in memory: wide arrays and objects split across threads,
+ * nested wide containers, every thread count, and the sink overload.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+namespace {
+    HMS::JsonValue wideArray(size_t n) {
+        HMS::JsonArray a;
+        for (size_t i = 0; i < n; ++i) {
+            if (i % 3 == 0) a.emplace_back(static_cast<int64_t>(i) - 7);
+            else if (i % 3 == 1) a.emplace_back("s\"" + std::to_string(i) + "\n");
+            else a.emplace_back(HMS::JsonArray{ HMS::JsonValue(i * 0.5), HMS::JsonValue(true), HMS::JsonValue() });
+        }
+        return HMS::JsonValue(std::move(a));
+    }
+
+    HMS::JsonValue wideObject(size_t n) {
+        HMS::JsonValue o;
+        for (size_t i = 0; i < n; ++i) o["key " + std::to_string(i)] = i % 2 ? HMS::JsonValue(static_cast<uint64_t>(UINT64_MAX - i)) : HMS::JsonValue(HMS::JsonObject{});
+        return o;
+    }
+
+    void same(const HMS::JsonValue& v) {
+        const std::string compact = HMS::serialize(v);
+        const std::string pretty  = HMS::serialize(v, true, 4);
+        for (unsigned threads : { 0u, 1u, 2u, 3u, 64u }) {
+            CHECK(HMS::serializeParallel(v, false, 2, threads) == compact);
+            CHECK(HMS::serializeParallel(v, true, 4, threads) == pretty);
+        }
+    }
+}
+
+int main() {
+    const size_t wide = HMS_JSON_PARALLEL_MIN_ELEMENTS * 3 + 17;
+
+    same(wideArray(wide));
+    same(wideObject(wide));
+    same(wideArray(HMS_JSON_PARALLEL_MIN_ELEMENTS - 1));
+    same(HMS::JsonValue(HMS::JsonArray{}));
+    same(HMS::JsonValue("scalar"));
+
+    // Wide containers below a wide container, and a wide member next to small ones.
+    HMS::JsonArray nested;
+    for (int i = 0; i < 3; ++i) nested.push_back(wideArray(HMS_JSON_PARALLEL_MIN_ELEMENTS + static_cast<size_t>(i)));
+    nested.push_back(wideObject(HMS_JSON_PARALLEL_MIN_ELEMENTS));
+    same(HMS::JsonValue(std::move(nested)));
+
+    HMS::JsonValue doc;
+    doc["a"] = 1;
+    doc["records"] = wideArray(wide);
+    doc["z"] = HMS::JsonArray{};
+    same(doc);
+
+    // The sink overload hands over the same bytes.
+    std::string chunks;
+    size_t writes = 0;
+    auto sink = HMS::makeSink([&](const char* data, size_t len) { chunks.append(data, len); writes++; });
+    HMS::JsonSerializer::serializeParallel(doc, sink, false, 2, 4);
+    CHECK(chunks == HMS::serialize(doc));
+    CHECK(writes > 1);
+
+    HMS::JsonCountingSink counter;
+    HMS::JsonSerializer::serializeParallel(doc, counter, true, 2, 4);
+    CHECK(counter.size() == HMS::serialize(doc, true).size());
+
+    return HMS::Test::result();
+}
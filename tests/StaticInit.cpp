@@ -0,0 +1,27 @@
+/*
+ * Parsing and serializing from a static initializer, before this translation unit's main() and
+ * in no particular order relative to the library's own namespace scope objects.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+namespace {
+    const char* const SOURCE = "{\"list\":[1,2,3],\"name\":\"a string well past the inline prefix\",\"nested\":{\"k\":\"v\\n\"}}";
+
+    HMS::JsonValue parseEarly() {
+        HMS::ParseError err;
+        return HMS::deserialize(SOURCE, err);
+    }
+
+    HMS::JsonValue       early  = parseEarly();
+    const std::string    text   = HMS::serialize(early);
+}
+
+int main() {
+    CHECK(early.isObject());
+    CHECK(early["name"].asString() == "a string well past the inline prefix");
+    CHECK(early["nested"]["k"].asString() == "v\n");
+    CHECK(text == SOURCE);
+    return HMS::Test::result();
+}
@@ -0,0 +1,56 @@
+/*
+ * JsonStats (HMS_JSON_STATS builds with threads): per call numbers, and a callback that always
+ * sees the user pointer registered with it, also while another thread swaps the registration.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+#if defined(HMS_JSON_STATS) && !defined(HMS_JSON_NO_THREADS)
+#include <atomic>
+#include <thread>
+
+namespace {
+    int                 tokenA;
+    int                 tokenB;
+    std::atomic<int>    mismatches{0};
+    std::atomic<int>    calls{0};
+
+    void reportA(const HMS::JsonStats&, void* user) { calls++; if (user != &tokenA) mismatches++; }
+    void reportB(const HMS::JsonStats&, void* user) { calls++; if (user != &tokenB) mismatches++; }
+}
+
+int main() {
+    HMS::ParseError err;
+    HMS::JsonValue v = HMS::deserialize("{\"a\":[1,2,{\"b\":null}]}", err);
+    CHECK(!err);
+    const HMS::JsonStats& parsed = HMS::JsonStats::last();
+    CHECK(parsed.operation == HMS::JsonStats::Parse && !parsed.failed);
+    CHECK(parsed.nodes == 6 && parsed.maxDepth == 3);
+
+    std::atomic<bool> stop{false};
+    std::thread swapper([&] {
+        while (!stop) {
+            HMS::JsonStats::setCallback(reportA, &tokenA);
+            HMS::JsonStats::setCallback(reportB, &tokenB);
+        }
+    });
+    std::thread parsers[4];
+    for (auto& t : parsers) {
+        t = std::thread([&] {
+            HMS::ParseError e;
+            for (int i = 0; i < 20000; ++i) HMS::deserialize("[1]", e);
+        });
+    }
+    for (auto& t : parsers) t.join();
+    stop = true;
+    swapper.join();
+    HMS::JsonStats::setCallback(nullptr);
+
+    CHECK(calls.load() > 0);
+    CHECK(mismatches.load() == 0);
+    return HMS::Test::result();
+}
+#else
+int main() { return 0; }
+#endif
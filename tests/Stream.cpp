@@ -0,0 +1,123 @@
+/*
+ * JsonStreamParser against the one shot parser: every document is fed whole, one byte at a time
+ * and in random chunks, and has to give the same value, or the same error at the same position.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+#include <random>
+
+namespace {
+    const char* const DOCUMENTS[] = {
+        "{\"name\":\"caf\\u00e9\",\"emoji\":\"\\ud83d\\ude00\",\"esc\":\"\\\"\\\\\\/\\b\\f\\n\\r\\t\",\"utf8\":\"\xC3\xA9\xE2\x82\xAC\"}",
+        "[0,-0,1,-1,12.5e-3,1E+2,9223372036854775807,-9223372036854775808,18446744073709551615,1e400]",
+        "  {\n  \"a\" : [ true , false , null ] ,\n  \"b\" : { \"c\" : { } , \"d\" : [ ] }\n}  ",
+        "{\"dup\":1,\"dup\":{\"x\":[1,2]},\"k\":\"v\"}",
+        "\"lone string\"",
+        "12345678901234567890123",
+        "true",
+        "[[[[[[[[[[\"deep\"]]]]]]]]]]",
+        // Errors, several of them spanning any chunk boundary
+        "{\"a\":1,}",
+        "[1,2",
+        "{\"a\" 1}",
+        "[tru]",
+        "[nulll]",
+        "[01]",
+        "[1.]",
+        "[-]",
+        "[1e]",
+        "\"bad \\x escape\"",
+        "\"bad \\u12G4\"",
+        "\"\\ud800 lone surrogate\"",
+        "\"unterminated",
+        "\"raw \n newline\"",
+        "\"bad utf8 \xC3\x28\"",
+        "{\"a\":1} trailing",
+        "{\"a\":1}\n\n  x",
+        "[1}",
+        "{1:2}",
+        "",
+        "   ",
+    };
+
+    struct Outcome {
+        std::string     text;
+        std::string     what;
+        HMS::ErrorPos   pos{0, 0};
+    };
+
+    Outcome oneShot(const std::string& doc) {
+        HMS::ParseError err;
+        HMS::JsonValue v = HMS::deserialize(doc, err);
+        return err ? Outcome{"", err.what, err.pos} : Outcome{HMS::serialize(v), "", {0, 0}};
+    }
+
+    Outcome streamed(const std::string& doc, const std::vector<size_t>& cuts) {
+        HMS::JsonStreamParser parser;
+        HMS::ParseError err;
+        size_t from = 0;
+        bool ok = true;
+        for (size_t cut : cuts) {
+            if (ok) ok = parser.feed(doc.data() + from, cut - from, err);
+            from = cut;
+        }
+        if (ok) ok = parser.feed(doc.data() + from, doc.size() - from, err);
+        if (ok) ok = parser.finish(err);
+        return ok ? Outcome{HMS::serialize(parser.value()), "", {0, 0}} : Outcome{"", err.what, err.pos};
+    }
+
+    void same(const std::string& doc, const std::vector<size_t>& cuts) {
+        Outcome expected    = oneShot(doc);
+        Outcome got         = streamed(doc, cuts);
+        bool ok = got.text == expected.text && got.what == expected.what
+               && got.pos.line == expected.pos.line && got.pos.col == expected.pos.col;
+        CHECK(ok);
+        if (!ok) {
+            std::fprintf(stderr, "  document: %s\n  expected: %s%s @%d:%d\n  streamed: %s%s @%d:%d\n", doc.c_str(),
+                         expected.text.c_str(), expected.what.c_str(), expected.pos.line, expected.pos.col,
+                         got.text.c_str(), got.what.c_str(), got.pos.line, got.pos.col);
+        }
+    }
+}
+
+int main() {
+    std::mt19937 random(12345);
+    for (const char* text : DOCUMENTS) {
+        std::string doc(text);
+
+        same(doc, {});
+
+        std::vector<size_t> bytes;
+        for (size_t i = 1; i < doc.size(); ++i) bytes.push_back(i);
+        same(doc, bytes);
+
+        for (int round = 0; round < 50; ++round) {
+            std::vector<size_t> cuts;
+            for (size_t at = 0; doc.size() > 1; ) {
+                at += 1 + random() % 7;
+                if (at >= doc.size()) break;
+                cuts.push_back(at);
+            }
+            same(doc, cuts);
+        }
+    }
+
+    // Each \u escape of a surrogate pair split at every byte, across separate feed() calls.
+    std::string pair = "[\"\\ud83d\\ude00\",\"\\u00e9\"]";
+    for (size_t a = 1; a < pair.size(); ++a) {
+        for (size_t b = a + 1; b < pair.size(); ++b) same(pair, {a, b});
+    }
+
+    // After an error the parser keeps reporting it until reset().
+    HMS::JsonStreamParser parser;
+    HMS::ParseError err;
+    CHECK(parser.feed("[1,", err));
+    CHECK(!parser.feed("}", err) && err.what == "Unexpected character '}'");
+    CHECK(!parser.feed("2]", err) && err.what == "Unexpected character '}'");
+    parser.reset();
+    CHECK(parser.feed("[2]", err) && parser.finish(err) && HMS::serialize(parser.value()) == "[2]");
+
+    return HMS::Test::result();
+}
@@ -0,0 +1,109 @@
+/*
+ * Stage one of the two stage parser. Documents are shifted byte by byte so quotes, escapes,
+ * backslash runs and multibyte characters land on every position around the 16, 32 and 64
+ * byte block edges. The structural index has to match a byte by byte reference and every
+ * parse has to produce the values the document was built from. The same program is also
+ * built with HMS_JSON_NO_AVX2 and HMS_JSON_NO_SIMD, so all kernels give identical results.
+ */
+
+#include "HMS_JSON.h"
+#include "HMS_JSON_Structural.h"
+#include "Check.h"
+
+namespace {
+    struct Piece {
+        const char* json;       // text inside a string literal
+        const char* value;      // what it decodes to
+    };
+
+    const Piece PIECES[] = {
+        { "\\\"",               "\""            },
+        { "\\\\",               "\\"            },
+        { "\\\\\\\\",           "\\\\"          },
+        { "\\\\\\\\\\\\",       "\\\\\\"        },
+        { "\\\\\\\"",           "\\\""          },
+        { "a\\nb\\t",           "a\nb\t"        },
+        { "\\u00e9\\ud83d\\ude00", "\xC3\xA9\xF0\x9F\x98\x80" },
+        { "\xC3\xA9\xE2\x82\xAC", "\xC3\xA9\xE2\x82\xAC" },
+        { "{}[]:, ",            "{}[]:, "       },
+    };
+
+    // Token starts outside strings, found one byte at a time.
+    std::vector<uint32_t> referenceIndex(const std::string& s) {
+        std::vector<uint32_t> tokens;
+        bool inString   = false;
+        bool inScalar   = false;
+        for (size_t i = 0; i < s.size(); ++i) {
+            char c = s[i];
+            if (inString) {
+                if (c == '\\') ++i;
+                else if (c == '"') inString = false;
+                continue;
+            }
+            if (c == '"') {
+                tokens.push_back(static_cast<uint32_t>(i));
+                inString = true;
+                inScalar = false;
+            } else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') {
+                tokens.push_back(static_cast<uint32_t>(i));
+                inScalar = false;
+            } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                inScalar = false;
+            } else {
+                if (!inScalar) tokens.push_back(static_cast<uint32_t>(i));
+                inScalar = true;
+            }
+        }
+        return tokens;
+    }
+
+    void check(const std::string& doc, const HMS::JsonValue& expected) {
+        if (HMS::detail::structuralIndexAvailable()) {
+            std::vector<uint32_t> tokens;
+            size_t badUtf8;
+            CHECK(HMS::detail::buildStructuralIndex(doc, tokens, badUtf8));
+            CHECK(badUtf8 == static_cast<size_t>(-1));
+            CHECK(tokens == referenceIndex(doc));
+        }
+        HMS::ParseError err;
+        HMS::JsonValue parsed = HMS::deserialize(doc, err);
+        CHECK(!err);
+        CHECK(HMS::serialize(parsed) == HMS::serialize(expected));
+    }
+}
+
+int main() {
+    for (size_t shift = 0; shift < 140; ++shift) {
+        std::string doc = std::string(shift % 7, ' ') + "[";
+        HMS::JsonArray expected;
+        for (const Piece& p : PIECES) {
+            std::string filler(shift, 'y');
+            doc += "\"" + filler + p.json + "\",";
+            expected.emplace_back(filler + p.value);
+        }
+        doc += "-12.5e3,true,null,{\"k\\\"\":[0]},\"" + std::string(shift, '\\') + std::string(shift, '\\') + "\"]\n";
+        expected.emplace_back(-12.5e3);
+        expected.emplace_back(true);
+        expected.emplace_back(nullptr);
+        HMS::JsonValue inner;
+        inner["k\""][0] = 0;
+        expected.emplace_back(inner);
+        expected.emplace_back(std::string(shift, '\\'));
+        check(doc, HMS::JsonValue(std::move(expected)));
+
+        // Quotes and backslashes right at the end of the input, in the zero padded last block
+        std::string tail(shift, 'z');
+        check("\"" + tail + "\\\\\"", HMS::JsonValue(tail + "\\"));
+        check("[" + std::string(shift, ' ') + "\"" + tail + "\\\"\"]", HMS::JsonValue(HMS::JsonArray{HMS::JsonValue(tail + "\"")}));
+    }
+
+    // Malformed UTF-8 straddling a block edge is found by stage one as well.
+    for (size_t at = 56; at < 72; ++at) {
+        std::string doc = "[\"" + std::string(at - 2, 'x') + "\xE2\x82" + "\"," + std::string(200, '1') + "]";
+        HMS::ParseError err;
+        HMS::deserialize(doc, err);
+        CHECK(err && err.pos.col == static_cast<int>(at) + 1);
+    }
+
+    return HMS::Test::result();
+}
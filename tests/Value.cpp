@@ -0,0 +1,66 @@
+/*
+ * JsonValue accessors: integer reads of doubles that do not fit the result type.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+#include <cmath>
+#include <limits>
+
+int main() {
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    CHECK(HMS::JsonValue(2.9).asInt64() == 2);
+    CHECK(HMS::JsonValue(-2.9).asInt64() == -2);
+    CHECK(HMS::JsonValue(2.9).asUInt64() == 2);
+
+    CHECK(HMS::JsonValue(1e300).asInt64() == INT64_MAX);
+    CHECK(HMS::JsonValue(-1e300).asInt64() == INT64_MIN);
+    CHECK(HMS::JsonValue(inf).asInt64() == INT64_MAX);
+    CHECK(HMS::JsonValue(-inf).asInt64() == INT64_MIN);
+    CHECK(HMS::JsonValue(nan).asInt64() == 0);
+    CHECK(HMS::JsonValue(9223372036854775808.0).asInt64() == INT64_MAX);
+    CHECK(HMS::JsonValue(-9223372036854775808.0).asInt64() == INT64_MIN);
+
+    CHECK(HMS::JsonValue(1e300).asUInt64() == UINT64_MAX);
+    CHECK(HMS::JsonValue(inf).asUInt64() == UINT64_MAX);
+    CHECK(HMS::JsonValue(18446744073709551616.0).asUInt64() == UINT64_MAX);
+    CHECK(HMS::JsonValue(-1.0).asUInt64() == 0);
+    CHECK(HMS::JsonValue(-inf).asUInt64() == 0);
+    CHECK(HMS::JsonValue(nan).asUInt64() == 0);
+
+    HMS::ParseError err;
+    HMS::JsonValue parsed = HMS::deserialize("[1e300,-1e300]", err);
+    CHECK(!err);
+    CHECK(parsed.asArray()[0].asInt64() == INT64_MAX && parsed.asArray()[1].asInt64() == INT64_MIN);
+
+    // Half precision infinity and NaN from CBOR
+    const uint8_t cbor[] = { 0x82, 0xF9, 0x7C, 0x00, 0xF9, 0x7E, 0x00 };
+    HMS::JsonValue decoded = HMS::JsonCbor::decode(cbor, sizeof(cbor), err);
+    CHECK(!err);
+    CHECK(decoded.asArray()[0].asInt64() == INT64_MAX && decoded.asArray()[1].asUInt64() == 0);
+
+    // The deprecated std::variant view of a node, for code written against the old member.
+    #if defined(__GNUC__)
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    #endif
+    HMS::JsonValue mixed = HMS::deserialize("{\"a\":[null,true,-1,18446744073709551615,0.5,\"s\"]}", err);
+    CHECK(!err);
+    const HMS::JsonArray& items = mixed["a"].asArray();
+    CHECK(std::holds_alternative<std::nullptr_t>(items[0].JsonVariant()));
+    CHECK(std::get<bool>(items[1].JsonVariant()));
+    CHECK(std::get<int64_t>(items[2].JsonVariant()) == -1);
+    CHECK(std::get<uint64_t>(items[3].JsonVariant()) == UINT64_MAX);
+    CHECK(std::get<double>(items[4].JsonVariant()) == 0.5);
+    CHECK(std::get<std::string>(items[5].JsonVariant()) == "s");
+    CHECK(std::get<HMS::JsonArray>(mixed["a"].JsonVariant()).size() == 6);
+    CHECK(std::get<HMS::JsonObject>(mixed.JsonVariant()).count("a") == 1);
+    #if defined(__GNUC__)
+        #pragma GCC diagnostic pop
+    #endif
+
+    return HMS::Test::result();
+}
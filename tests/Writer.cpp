@@ -0,0 +1,38 @@
+/*
+ * JsonWriter: the calls users write most, and that the output matches the serializer's.
+ */
+
+#include "HMS_JSON.h"
+#include "Check.h"
+
+int main() {
+    const std::string name  = "sensor";
+    std::string       unit  = "C";
+
+    std::string out;
+    {
+        HMS::JsonStringSink sink(out);
+        HMS::JsonWriter w(sink);
+        w.beginObject()
+            .member("name", name)
+            .member("unit", unit)
+            .member("id", 7)
+            .key("tags").beginArray().value(name).value(unit).value(std::string("tmp")).value("lit").endArray()
+        .endObject();
+        CHECK(w.depth() == 0);
+    }
+    CHECK(out == "{\"name\":\"sensor\",\"unit\":\"C\",\"id\":7,\"tags\":[\"sensor\",\"C\",\"tmp\",\"lit\"]}");
+
+    HMS::JsonValue tree;
+    tree["name"] = name;
+    tree["zero"] = 0;
+    std::string pretty;
+    {
+        HMS::JsonStringSink sink(pretty);
+        HMS::JsonWriter w(sink, true);
+        w.beginObject().member("name", name).member("zero", 0).endObject();
+    }
+    CHECK(pretty == HMS::serialize(tree, true));
+
+    return HMS::Test::result();
+}